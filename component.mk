@@ -9,4 +9,18 @@ COMPONENT_OBJS := \
     src/timer.o \
     src/event.o \
     src/io.o \
-    src/iothread.o
+    src/iothread.o \
+    src/frame.o \
+    src/co.o \
+    src/embed.o \
+    src/group.o \
+    src/stats.o \
+    src/prof.o \
+    src/mem.o \
+    src/sched.o \
+    src/mpq.o \
+    src/topic.o \
+    src/sampler.o \
+    src/log.o \
+    src/corr.o \
+    src/backoff.o
@@ -0,0 +1,91 @@
+/* libuEv - Retries with exponential backoff and jitter
+ *
+ * A backoff scheduler runs the retries of any number of clients off a
+ * single timer watcher, with the pending retries kept in a min-heap by
+ * due time.  Jitter spreads out clients that failed at the same time,
+ * e.g. on reconnect after an access point outage, and caps on attempts
+ * and on total time make a client give up.
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_BACKOFF_H
+#define LIBUEV_BACKOFF_H
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Backoff policies, delays are capped at the max. delay of the retry */
+#define UEV_BACKOFF_EXP           1	/* base * 2^attempt */
+#define UEV_BACKOFF_FULL_JITTER   2	/* random in [0, base * 2^attempt] */
+#define UEV_BACKOFF_DECORRELATED  3	/* random in [base, 3 * previous delay] */
+
+struct uev_retry;
+
+/* Time for attempt number @attempt, counting from 1 */
+typedef void (uev_retry_cb_t)(struct uev_retry *r, void *arg, unsigned int attempt);
+
+/* Backoff scheduler */
+typedef struct {
+	uev_t               w;
+	struct uev_retry  **heap;
+	size_t              capacity;
+	size_t              count;
+	uint32_t            seed;
+} uev_backoff_t;
+
+/* Retry state of one client */
+typedef struct uev_retry {
+	uev_backoff_t      *b;
+	uev_retry_cb_t     *cb;
+	void               *arg;
+
+	int                 policy;
+	unsigned int        base;		/* milliseconds */
+	unsigned int        max;		/* milliseconds */
+	unsigned int        max_attempts;	/* or zero for no limit */
+	unsigned int        budget;		/* milliseconds, or zero for no limit */
+
+	unsigned int        attempt;
+	unsigned int        delay;		/* Previous delay */
+	uint64_t            started;
+	uint64_t            due;
+	size_t              pos;		/* Heap index, or SIZE_MAX */
+} uev_retry_t;
+
+int uev_backoff_init   (uev_ctx_t *ctx, uev_backoff_t *b, size_t capacity);
+int uev_backoff_stop   (uev_backoff_t *b);
+
+int uev_retry_init     (uev_backoff_t *b, uev_retry_t *r, uev_retry_cb_t *cb, void *arg,
+			int policy, unsigned int base, unsigned int max);
+int uev_retry_limit    (uev_retry_t *r, unsigned int max_attempts, unsigned int budget);
+int uev_retry_schedule (uev_retry_t *r);
+int uev_retry_cancel   (uev_retry_t *r);
+int uev_retry_reset    (uev_retry_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_BACKOFF_H */
@@ -0,0 +1,133 @@
+/* libuEv - Stackless coroutines resumed from the event loop
+ *
+ * A coroutine is a function which is re-entered at the point where it
+ * last waited, like a protothread.  It has no stack of its own, so
+ * local variables do not survive a wait and must be kept in the state
+ * passed as @arg.  Each coroutine owns a watcher which is re-purposed
+ * for whatever it waits on next, and an event watcher of its own for
+ * posts from other tasks and interrupts.
+ *
+ * Example:
+ *
+ *	static int session(uev_co_t *co, void *arg)
+ *	{
+ *		struct session *s = arg;
+ *
+ *		UEV_CO_BEGIN(co);
+ *		for (;;) {
+ *			UEV_CO_READABLE(co, s->fd);
+ *			if (co->events & UEV_ERROR)
+ *				break;
+ *			...
+ *			UEV_CO_SLEEP(co, 100);
+ *		}
+ *		UEV_CO_END(co);
+ *	}
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_CO_H
+#define LIBUEV_CO_H
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Coroutine return values */
+#define UEV_CO_DONE     0
+#define UEV_CO_WAIT     1
+
+/* What a suspended coroutine waits for */
+#define UEV_CO_WAIT_IO     1
+#define UEV_CO_WAIT_TIMER  2
+#define UEV_CO_WAIT_EVENT  3
+
+typedef struct uev_co uev_co_t;
+typedef int (uev_co_fn_t)(uev_co_t *co, void *arg);
+
+/* Coroutine frame, fixed size regardless of the coroutine body */
+struct uev_co {
+	/* The watcher used for all waits on I/O and time */
+	uev_t           w;
+
+	/* Event watcher for uev_co_post(), never used for anything else */
+	uev_t           ev;
+
+	uev_co_fn_t    *fn;
+	void           *arg;
+
+	/* Resume point, zero at start and -1 when finished */
+	int             lc;
+	int             wait;
+	atomic_int      posted;
+
+	/* Events returned by the last wait, check for %UEV_ERROR */
+	int             events;
+};
+
+#define uev_co_active(co)  ((co)->lc >= 0)
+
+/* Coroutine body, must be the first and last statement of the function */
+#define UEV_CO_BEGIN(co)  switch ((co)->lc) { case 0:
+#define UEV_CO_END(co)    } (co)->lc = -1; return UEV_CO_DONE
+
+/* Finish the coroutine early */
+#define UEV_CO_EXIT(co)   do { (co)->lc = -1; return UEV_CO_DONE; } while (0)
+
+/*
+ * Arm the watcher with @arm and suspend.  Arming returns 1 when the
+ * condition is already met, in which case the coroutine carries on
+ * without returning to the event loop, and -1 on error, which is
+ * reported as %UEV_ERROR in @co->events.
+ */
+#define _UEV_CO_AWAIT(co, arm) do {					\
+	int _rc;							\
+	(co)->lc = __LINE__;						\
+	_rc = (arm);							\
+	if (!_rc)							\
+		return UEV_CO_WAIT;					\
+	(co)->events = _rc > 0 ? UEV_READ : UEV_ERROR;			\
+	case __LINE__:;							\
+} while (0)
+
+#define UEV_CO_READABLE(co, fd)  _UEV_CO_AWAIT(co, _uev_co_io(co, fd, UEV_READ))
+#define UEV_CO_WRITABLE(co, fd)  _UEV_CO_AWAIT(co, _uev_co_io(co, fd, UEV_WRITE))
+/* Sleep @ms milliseconds, zero yields once to the other watchers */
+#define UEV_CO_SLEEP(co, ms)     _UEV_CO_AWAIT(co, _uev_co_timer(co, ms))
+#define UEV_CO_EVENT(co)         _UEV_CO_AWAIT(co, _uev_co_event(co))
+
+int uev_co_start       (uev_ctx_t *ctx, uev_co_t *co, uev_co_fn_t *fn, void *arg);
+int uev_co_stop        (uev_co_t *co);
+int uev_co_post        (uev_co_t *co);
+
+/* Private to libuEv, used by the wait macros */
+int _uev_co_io         (uev_co_t *co, int fd, int events);
+int _uev_co_timer      (uev_co_t *co, int timeout);
+int _uev_co_event      (uev_co_t *co);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_CO_H */
@@ -0,0 +1,347 @@
+/* libuEv - C++20 coroutines over libuEv watchers
+ *
+ * Coroutine frames are carved from a fixed block pool owned by the
+ * context, so allocation is deterministic and never touches the heap.
+ * Suspended coroutines are resumed straight from the watcher callback
+ * in uev_run(), there is no intermediate run queue.
+ *
+ * A coroutine returns uev::Task and takes its uev::CoContext as the
+ * first parameter, which is how the promise finds the frame pool:
+ *
+ *	uev::Task session(uev::CoContext &ctx, int fd)
+ *	{
+ *		uev::Socket sock(ctx, fd);
+ *
+ *		for (;;) {
+ *			if (co_await sock.readable() & UEV_ERROR)
+ *				break;
+ *			...
+ *			co_await uev::sleep(ctx, 10ms);
+ *		}
+ *	}
+ *
+ *	uev::StaticCoContext<512, 64> ctx;
+ *	if (!session(ctx, fd))
+ *		... pool exhausted ...
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_CORO_HPP
+#define LIBUEV_CORO_HPP
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+
+#include "uev.hpp"
+
+namespace uev {
+
+/* Context with a pool of fixed-size coroutine frames */
+class CoContext : public Context {
+public:
+	/* Each block starts with a pointer back to the owning context */
+	static constexpr std::size_t header = alignof(std::max_align_t);
+
+	/*
+	 * A @buf not aligned to max_align_t, or a @block too small for the
+	 * header or not a multiple of that alignment, leaves the pool empty
+	 * and the context converting to false.
+	 */
+	CoContext(void *buf, std::size_t block, std::size_t count) noexcept
+		: block_(0), free_(nullptr)
+	{
+		unsigned char *p = static_cast<unsigned char *>(buf);
+
+		if (!p || block <= header || block % alignof(std::max_align_t) ||
+		    reinterpret_cast<std::uintptr_t>(p) % alignof(std::max_align_t))
+			return;
+
+		block_ = block;
+		for (std::size_t i = 0; i < count; i++)
+			push(p + i * block);
+	}
+
+	explicit operator bool() const noexcept { return block_ && Context::operator bool(); }
+
+	void *alloc_frame(std::size_t size) noexcept
+	{
+		Block *b = free_;
+
+		if (!b || size > block_ - header)
+			return nullptr;
+
+		free_ = b->next;
+		b->owner = this;
+
+		return reinterpret_cast<unsigned char *>(b) + header;
+	}
+
+	static void free_frame(void *frame) noexcept
+	{
+		Block *b = reinterpret_cast<Block *>(static_cast<unsigned char *>(frame) - header);
+
+		b->owner->push(b);
+	}
+
+private:
+	union Block {
+		Block     *next;
+		CoContext *owner;
+	};
+
+	void push(void *p) noexcept
+	{
+		Block *b = static_cast<Block *>(p);
+
+		b->next = free_;
+		free_ = b;
+	}
+
+	std::size_t block_;
+	Block      *free_;
+};
+
+/* Context with @Count statically allocated frames of up to @Size bytes each */
+template <std::size_t Size, std::size_t Count>
+class StaticCoContext : public CoContext {
+	static constexpr std::size_t block =
+		(Size + header + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+public:
+	StaticCoContext() noexcept : CoContext(storage_, block, Count) {}
+
+private:
+	alignas(std::max_align_t) unsigned char storage_[block * Count];
+};
+
+/*
+ * Fire-and-forget coroutine.  It runs until its first suspension when
+ * called and its frame is returned to the pool when it finishes.  A
+ * Task converting to false means the pool was exhausted and the
+ * coroutine never ran.
+ */
+class Task {
+public:
+	/*
+	 * Promise of a coroutine taking (CoContext &, Args...), selected by
+	 * the std::coroutine_traits specialization below.  Being a class
+	 * template rather than a template operator new keeps the pool
+	 * allocation and deallocation functions a plain matching pair.
+	 */
+	template <class... Args>
+	struct promise {
+		static void *operator new(std::size_t size, CoContext &ctx, const Args &...) noexcept
+		{
+			return ctx.alloc_frame(size);
+		}
+
+		/* Frames must come from a context pool, never the heap */
+		static void *operator new(std::size_t) = delete;
+
+		static void operator delete(void *frame) noexcept { CoContext::free_frame(frame); }
+
+		static Task get_return_object_on_allocation_failure() noexcept { return Task(false); }
+		Task get_return_object() noexcept { return Task(true); }
+
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+	};
+
+	explicit operator bool() const noexcept { return ok_; }
+
+private:
+	explicit Task(bool ok) noexcept : ok_(ok) {}
+
+	bool ok_;
+};
+
+/* co_await uev::sleep(ctx, 10ms), resumes with %UEV_READ or %UEV_ERROR */
+class Sleep : public detail::Watcher {
+public:
+	Sleep(uev_ctx_t *ctx, int timeout) noexcept : ctx_(ctx), timeout_(timeout) {}
+	~Sleep() { uev_timer_stop(&w_); }
+
+	bool await_ready() const noexcept { return timeout_ <= 0; }
+
+	bool await_suspend(std::coroutine_handle<> h) noexcept
+	{
+		h_ = h;
+		rc_ = uev_timer_init(ctx_, &w_, &trampoline, this, timeout_, 0);
+
+		return rc_ == 0;
+	}
+
+	int await_resume() const noexcept { return rc_ ? UEV_ERROR : UEV_READ; }
+
+private:
+	static void trampoline(uev_t *, void *arg, int)
+	{
+		static_cast<Sleep *>(arg)->h_.resume();
+	}
+
+	uev_ctx_t              *ctx_;
+	int                     timeout_;
+	std::coroutine_handle<> h_;
+};
+
+template <class Rep, class Period>
+inline Sleep sleep(uev_ctx_t *ctx, std::chrono::duration<Rep, Period> d) noexcept
+{
+	return Sleep(ctx, static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(d).count()));
+}
+
+/*
+ * Socket with awaitable readiness, co_await sock.readable() resumes
+ * with the returned events.  Only one coroutine may wait on a socket at
+ * a time.  The watcher is kept armed across back-to-back waits for the
+ * same events, so a read loop does not re-register with the iothread.
+ */
+class Socket : public detail::Watcher {
+	class Awaiter {
+	public:
+		Awaiter(Socket &sock, int events) noexcept : sock_(sock), events_(events) {}
+
+		bool await_ready() const noexcept { return false; }
+
+		bool await_suspend(std::coroutine_handle<> h) noexcept
+		{
+			return sock_.wait(h, events_) == 0;
+		}
+
+		int await_resume() const noexcept { return sock_.revents_; }
+
+	private:
+		Socket &sock_;
+		int     events_;
+	};
+
+public:
+	Socket(uev_ctx_t *ctx, int fd) noexcept : ctx_(ctx), fd_(fd) {}
+	~Socket()
+	{
+		if (uev_io_active(&w_))
+			uev_io_stop(&w_);
+	}
+
+	int fd() const noexcept { return fd_; }
+
+	Awaiter readable() noexcept { return Awaiter(*this, UEV_READ); }
+	Awaiter writable() noexcept { return Awaiter(*this, UEV_WRITE); }
+
+private:
+	int wait(std::coroutine_handle<> h, int events) noexcept
+	{
+		h_ = h;
+		revents_ = UEV_ERROR;
+
+		if (uev_io_active(&w_) && w_.events == events)
+			return 0;
+
+		if (uev_io_active(&w_))
+			rc_ = uev_io_set(&w_, fd_, events);
+		else
+			rc_ = uev_io_init(ctx_, &w_, &trampoline, this, fd_, events);
+
+		return rc_;
+	}
+
+	static void trampoline(uev_t *w, void *arg, int events)
+	{
+		Socket *self = static_cast<Socket *>(arg);
+		std::coroutine_handle<> h = self->h_;
+
+		/* Nobody waiting, stop polling until the next wait */
+		if (!h) {
+			uev_io_stop(w);
+			return;
+		}
+
+		self->h_ = nullptr;
+		self->revents_ = events;
+		h.resume();
+	}
+
+	uev_ctx_t              *ctx_;
+	int                     fd_;
+	int                     revents_ = 0;
+	std::coroutine_handle<> h_;
+};
+
+/*
+ * Awaitable event, co_await event resumes once post() has been called.
+ * Posts made while nobody is waiting are remembered, post() is safe from
+ * other tasks and interrupts.
+ */
+class AsyncEvent : public detail::Watcher {
+public:
+	explicit AsyncEvent(uev_ctx_t *ctx) noexcept
+	{
+		rc_ = uev_event_init(ctx, &w_, &trampoline, this);
+	}
+	~AsyncEvent() { uev_event_stop(&w_); }
+
+	int post() noexcept { return uev_event_post(&w_); }
+
+	bool await_ready() noexcept
+	{
+		if (!pending_)
+			return false;
+
+		pending_ = false;
+		return true;
+	}
+
+	void await_suspend(std::coroutine_handle<> h) noexcept { h_ = h; }
+	void await_resume() const noexcept {}
+
+private:
+	static void trampoline(uev_t *, void *arg, int)
+	{
+		AsyncEvent *self = static_cast<AsyncEvent *>(arg);
+		std::coroutine_handle<> h = self->h_;
+
+		if (!h) {
+			self->pending_ = true;
+			return;
+		}
+
+		self->h_ = nullptr;
+		h.resume();
+	}
+
+	bool                    pending_ = false;
+	std::coroutine_handle<> h_;
+};
+
+} /* namespace uev */
+
+template <class... Args>
+struct std::coroutine_traits<uev::Task, uev::CoContext &, Args...> {
+	using promise_type = uev::Task::promise<Args...>;
+};
+
+#endif /* LIBUEV_CORO_HPP */
@@ -0,0 +1,81 @@
+/* libuEv - Correlation of responses with in-flight requests
+ *
+ * Tracks requests by ID until they are completed or time out.  Entries
+ * come from a preallocated pool and are found through an open addressed
+ * hash index.  All requests share one timeout, so their deadlines are
+ * in insertion order and a single timer watcher, armed for the oldest
+ * request, serves the whole table.  Insert, complete and expiry are
+ * all O(1).
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_CORR_H
+#define LIBUEV_CORR_H
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct uev_corr;
+
+/* Called when request @id times out, with the @data it was inserted with */
+typedef void (uev_corr_cb_t)(struct uev_corr *c, void *arg, uint32_t id, void *data);
+
+/* In-flight request */
+typedef struct uev_corr_entry {
+	struct uev_corr_entry *next, *prev;	/* Deadline order, or free list */
+	uint32_t        id;
+	void           *data;
+	uint64_t        deadline;		/* milliseconds */
+} uev_corr_entry_t;
+
+/* Correlation table */
+typedef struct uev_corr {
+	uev_t           w;
+
+	uev_corr_cb_t  *cb;
+	void           *arg;
+	int             timeout;
+
+	uev_corr_entry_t  *pool;
+	uev_corr_entry_t **index;
+	size_t          capacity;
+	size_t          mask;		/* Index size - 1 */
+	size_t          count;
+
+	uev_corr_entry_t  *free;
+	uev_corr_entry_t  *head, *tail;	/* Oldest and newest request */
+} uev_corr_t;
+
+int uev_corr_init      (uev_ctx_t *ctx, uev_corr_t *c, uev_corr_cb_t *cb, void *arg,
+			size_t capacity, int timeout);
+int uev_corr_insert    (uev_corr_t *c, uint32_t id, void *data);
+int uev_corr_complete  (uev_corr_t *c, uint32_t id, void **data);
+int uev_corr_stop      (uev_corr_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_CORR_H */
@@ -0,0 +1,93 @@
+/* libuEv - Message framing decoders for stream watchers
+ *
+ * A framing decoder owns an I/O watcher and a read ring.  Received data
+ * is split into frames which are handed to the callback as views into
+ * the ring, so complete frames are parsed without intermediate copies.
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_FRAME_H
+#define LIBUEV_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Framing modes */
+#define UEV_FRAME_FIXED   1	/* Fixed-length frames, param is the length */
+#define UEV_FRAME_LENPFX  2	/* Big endian length prefix, param is 1, 2 or 4 */
+#define UEV_FRAME_DELIM   3	/* Delimited frames, param is the delimiter */
+
+/*
+ * A complete frame.  Frames wrapping around the end of the ring are
+ * split in two spans, otherwise @len[1] is zero.  The view is only
+ * valid for the duration of the callback.
+ */
+typedef struct {
+	const uint8_t  *ptr[2];
+	size_t          len[2];
+} uev_frame_view_t;
+
+struct uev_frame;
+
+/*
+ * Frame callback, @v is a complete frame with @events set to %UEV_READ.
+ * On end of stream @events is %UEV_HUP and on read errors or frames
+ * which can never fit the ring it is %UEV_ERROR.  In both cases @v is
+ * NULL and the decoder has already been stopped.
+ */
+typedef void (uev_frame_cb_t)(struct uev_frame *f, void *arg, const uev_frame_view_t *v, int events);
+
+/* Framing decoder */
+typedef struct uev_frame {
+	/* Underlying I/O watcher */
+	uev_t           w;
+
+	/* Read ring, free running positions masked with size - 1 */
+	uint8_t        *buf;
+	size_t          size;
+	size_t          head;
+	size_t          tail;
+	size_t          scan;
+
+	int             mode;
+	size_t          param;
+	int             allocated;
+
+	uev_frame_cb_t *cb;
+	void           *arg;
+} uev_frame_t;
+
+int uev_frame_init     (uev_ctx_t *ctx, uev_frame_t *f, uev_frame_cb_t *cb, void *arg, int fd,
+			void *buf, size_t size, int mode, size_t param);
+int uev_frame_stop     (uev_frame_t *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_FRAME_H */
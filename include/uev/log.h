@@ -0,0 +1,84 @@
+/* libuEv - Asynchronous log sink drained by the event loop
+ *
+ * Any task or ISR appends a fixed size record, a format string and up
+ * to UEV_LOG_ARGS int arguments, to a lock-free ring.  Nothing is
+ * formatted or written at that point.  The event loop formats the
+ * records and hands them to an output function in batches when it has
+ * nothing else to do.  A full ring drops records and counts them.
+ *
+ * Example:
+ *
+ *	uev_log(&log, "rx %d bytes on fd %d", len, fd);
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_LOG_H
+#define LIBUEV_LOG_H
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Max. number of int arguments per record */
+#define UEV_LOG_ARGS    6
+
+/* Size of the output buffer, bounds the output of one batch */
+#ifndef UEV_LOG_BUFSZ
+#define UEV_LOG_BUFSZ   256
+#endif
+
+/* Write @len bytes of formatted records, called from the event loop */
+typedef void (uev_log_out_t)(void *arg, const char *buf, size_t len);
+
+/* Log sink, one per context */
+typedef struct uev_log {
+	uev_ctx_t      *ctx;
+	struct uev_mpq *q;
+
+	uev_log_out_t  *out;
+	void           *arg;
+
+	atomic_int      armed;		/* Loop woken for the queued records */
+	atomic_uint     dropped;	/* Records lost, ring full */
+	unsigned int    reported;	/* Dropped records reported so far */
+
+	char            buf[UEV_LOG_BUFSZ];
+} uev_log_t;
+
+int uev_log_init       (uev_ctx_t *ctx, uev_log_t *l, uev_log_out_t *out, void *arg, size_t capacity);
+int uev_log_stop       (uev_log_t *l);
+int uev_log_put        (uev_log_t *l, const char *fmt, int nargs, ...);
+
+/* Log a record, @fmt must be a string constant, all arguments int */
+#define uev_log(l, fmt, ...)							\
+	uev_log_put(l, fmt, _UEV_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+#define _UEV_LOG_NARGS(...)  _UEV_LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define _UEV_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_LOG_H */
@@ -28,7 +28,26 @@
 #include <stdio.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/event_groups.h>
+#include <freertos/task.h>
+
+#ifdef __cplusplus
+#include <atomic>
+using std::atomic_int;
+using std::atomic_uint;
+using std::atomic_uintptr_t;
+using std::atomic_size_t;
+
+extern "C" {
+#else
 #include <stdatomic.h>
+#endif
+
+/* The watcher struct tag would clash with namespace uev in C++ */
+#ifdef __cplusplus
+#define _UEV_WATCHER uev_watcher
+#else
+#define _UEV_WATCHER uev
+#endif
 
 /*
  * List functions.
@@ -68,8 +87,39 @@ typedef enum {
 	UEV_TIMER_TYPE,
 	UEV_TIMER_TS_TYPE,
 	UEV_EVENT_TYPE,
+	UEV_EMBED_TYPE,
 } uev_type_t;
 
+/* Per-type watcher lists of a context, see _uev_list_index() */
+enum {
+	UEV_LIST_IO = 0,
+	UEV_LIST_TIMER,
+	UEV_LIST_EVENT,
+	UEV_LIST_EMBED,
+	UEV_LIST_MAX
+};
+
+static inline int _uev_list_index(uev_type_t type)
+{
+	switch (type) {
+	case UEV_IO_TYPE:
+		return UEV_LIST_IO;
+
+	case UEV_TIMER_TYPE:
+	case UEV_TIMER_TS_TYPE:
+		return UEV_LIST_TIMER;
+
+	case UEV_EVENT_TYPE:
+		return UEV_LIST_EVENT;
+
+	default:
+		return UEV_LIST_EMBED;
+	}
+}
+
+/* The list head of a watcher in its context */
+#define _UEV_LIST(w) ((w)->ctx->watchers[_uev_list_index((w)->type)])
+
 struct uev_list_node {
     struct uev_list_node *prev;
     struct uev_list_node *next;
@@ -82,37 +132,139 @@ struct uev_list_node {
 #define UEV_EG_BIT_IO (1 << 0)
 #define UEV_EG_BIT_EVENT (1 << 1)
 #define UEV_EG_BIT_TIMER (1 << 2)
-#define UEV_EG_MASK (UEV_EG_BIT_IO | UEV_EG_BIT_EVENT | UEV_EG_BIT_TIMER)
+#define UEV_EG_BIT_EMBED (1 << 3)
+#define UEV_EG_BIT_SCHED (1 << 4)
+#define UEV_EG_BIT_LOG (1 << 5)
+#define UEV_EG_MASK (UEV_EG_BIT_IO | UEV_EG_BIT_EVENT | UEV_EG_BIT_TIMER | UEV_EG_BIT_EMBED | \
+		     UEV_EG_BIT_SCHED | UEV_EG_BIT_LOG)
+
+/* Wakeup bit of each list, timers and embeds are also due by deadline */
+static inline EventBits_t _uev_list_bit(int list)
+{
+	switch (list) {
+	case UEV_LIST_IO:
+		return UEV_EG_BIT_IO;
+
+	case UEV_LIST_TIMER:
+		return UEV_EG_BIT_TIMER;
+
+	case UEV_LIST_EVENT:
+		return UEV_EG_BIT_EVENT;
+
+	default:
+		return UEV_EG_BIT_EMBED;
+	}
+}
+
+#if CONFIG_UEV_STATS
+/* Per-context statistics, times in microseconds unless noted */
+typedef struct {
+	uint32_t        wakeups;
+	uint32_t        dispatches;
+	uint64_t        cb_time;
+	uint32_t        cb_max;
+	uint32_t        timers_fired;
+	uint64_t        timer_late;	/* milliseconds */
+	uint32_t        timer_late_max;	/* milliseconds */
+} uev_stats_ctx_t;
+
+#define _UEV_WATCHER_STATS					\
+	struct {						\
+		uint32_t dispatches;				\
+		uint32_t cb_max;				\
+		uint64_t cb_time;				\
+	} stats;
+#else
+#define _UEV_WATCHER_STATS
+#endif
 
 /* Main libuEv context type */
 typedef struct {
 	atomic_int         running;
 	EventGroupHandle_t egh;
+
+	/* Bits set in egh and not yet taken by the loop */
+	atomic_uint        wake_pending;
 #if configSUPPORT_STATIC_ALLOCATION
 	StaticEventGroup_t egb;
 #endif
-	struct uev     *watchers;
+	struct _UEV_WATCHER *watchers[UEV_LIST_MAX];
 	int             watchers_changed;
+
+	/* Earliest deadline in each list as of its last scan */
+	uint64_t        list_deadline[UEV_LIST_MAX];
+
+	/* Task running the loop, wakeups from it need no kernel call */
+	TaskHandle_t    owner;
+
+	/*
+	 * Wakeup bits set from the owner task, or consumed but not fully
+	 * served by uev_run_for().  Only touched by the owner task.
+	 */
+	EventBits_t     pending;
+
+	/* Earliest deadline of all lists */
+	uint64_t        next_deadline;
+
+	/* Watcher in a parent context this context is embedded in */
+	struct _UEV_WATCHER *embed;
+
+	/* Watcher whose callback is running, if any */
+	struct _UEV_WATCHER *current;
+
+	/* Task deque, see uev_sched_attach() */
+	struct uev_sched_q *sched;
+
+	/* Log sink, see uev_log_init() */
+	struct uev_log *log;
+
+#if CONFIG_UEV_PROFILER
+	/* Callback being dispatched, read by the sampling profiler */
+	atomic_uintptr_t prof_cb;
+#endif
+
+#if CONFIG_UEV_STATS
+	uev_stats_ctx_t stats;
+#endif
+
+	/* Memory allocated on behalf of this context, see uev_mem_limit() */
+	struct {
+		atomic_size_t used;
+		atomic_size_t peak;
+		size_t        limit;
+	} mem;
 } uev_ctx_t;
 
 /* Forward declare due to dependencys, don't try this at home kids. */
-struct uev;
+struct _UEV_WATCHER;
+struct uev_group;
 
 /* This is used to hide all private data members in uev_t */
 #define uev_private_t                                           \
-	struct uev     *next, *prev;				\
+	struct _UEV_WATCHER *next, *prev;			\
 	struct {						\
-		struct uev_list_node node;			\
-		atomic_uint events;				\
+		/* Next is read lock-free by the iothread */	\
+		atomic_uintptr_t next;				\
+		struct _UEV_WATCHER *prev;			\
+		atomic_uint mask;	/* Events polled for */	\
+		atomic_uint events;	/* Events ready */	\
+		int bad;	/* Descriptor closed under us */	\
 	} iot;							\
 								\
 	int             active;                                 \
 	int             events;                                 \
 								\
+	/* Optional watcher group membership */			\
+	struct uev_group *group;				\
+	struct uev_list_node gnode;				\
+	struct _UEV_WATCHER *gself;	/* Itself while a member */	\
+								\
 	/* Watcher callback with optional argument */           \
-	void          (*cb)(struct uev *, void *, int);         \
+	void          (*cb)(struct _UEV_WATCHER *, void *, int);	\
 	void           *arg;                                    \
 								\
+	_UEV_WATCHER_STATS					\
+								\
 								\
 	/* Arguments for different watchers */			\
 	union {							\
@@ -127,28 +279,57 @@ struct uev;
 		struct {					\
 			atomic_int posted;			\
 		} e;						\
+								\
+		/* Embed watchers */				\
+		struct {					\
+			uev_ctx_t *ctx;				\
+		} c;						\
 	} u;							\
 								\
 	/* Watcher type */					\
 	uev_type_t
 
 /* Internal API for dealing with generic watchers */
-int _uev_watcher_init  (uev_ctx_t *ctx, struct uev *w, uev_type_t type,
-			void (*cb)(struct uev *, void *, int), void *arg,
+int _uev_watcher_init  (uev_ctx_t *ctx, struct _UEV_WATCHER *w, uev_type_t type,
+			void (*cb)(struct _UEV_WATCHER *, void *, int), void *arg,
 			int fd, int events);
-int _uev_watcher_start (struct uev *w);
-int _uev_watcher_stop  (struct uev *w);
-int _uev_watcher_active(struct uev *w);
-int _uev_watcher_rearm (struct uev *w);
+int _uev_watcher_start (struct _UEV_WATCHER *w);
+int _uev_watcher_stop  (struct _UEV_WATCHER *w);
+int _uev_watcher_unlink(struct _UEV_WATCHER *w);
+int _uev_watcher_held  (struct _UEV_WATCHER *w);
+void _uev_watcher_forget(struct _UEV_WATCHER *w);
+int _uev_watcher_active(struct _UEV_WATCHER *w);
+int _uev_watcher_rearm (struct _UEV_WATCHER *w);
 
 /* Internal iothread API */
-void _uev_iothread_watcher_add(struct uev *w);
-void _uev_iothread_watcher_remove(struct uev *w);
+void _uev_iothread_watcher_add(struct _UEV_WATCHER *w);
+void _uev_iothread_watcher_unlink(struct _UEV_WATCHER *w);
 void _uev_iothread_interrupt(void);
+#if CONFIG_UEV_STATS
+void _uev_iothread_stats(uint32_t *rounds, uint32_t *round_last, uint32_t *round_max);
+#endif
+
+/* Internal embed API */
+int _uev_embed_pending(uev_ctx_t *child);
+
+/* Internal scheduler API */
+int _uev_sched_run(uev_ctx_t *ctx);
+int _uev_sched_slice(uev_ctx_t *ctx);
+void _uev_sched_awake(uev_ctx_t *ctx);
+
+/* Internal log sink API */
+int _uev_log_drain(uev_ctx_t *ctx);
 
 /* Internal timer API */
 uint64_t _uev_timer_now(void);
-int _uev_timer_stop(struct uev *w);
+uint64_t _uev_timer_start_all(uev_ctx_t *ctx);
+int _uev_timer_stop(struct _UEV_WATCHER *w);
+
+/* Internal API for accounted memory */
+int   _uev_mem_charge  (uev_ctx_t *ctx, size_t size);
+void  _uev_mem_uncharge(uev_ctx_t *ctx, size_t size);
+void *_uev_malloc      (uev_ctx_t *ctx, size_t size);
+void  _uev_free        (uev_ctx_t *ctx, void *ptr, size_t size);
 
 /* Internal API for locks */
 void _uev_critical_enter(void);
@@ -157,6 +338,10 @@ void _uev_critical_exit(void);
 /* Internal API for setting flags */
 void _uev_set_flags(uev_ctx_t *ctx, const EventBits_t bits);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* LIBUEV_PRIVATE_H_ */
 
 /**
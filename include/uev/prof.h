@@ -0,0 +1,70 @@
+/* libuEv - Sampling profiler for loop callbacks, requires CONFIG_UEV_PROFILER
+ *
+ * A periodic high resolution timer samples which callback, if any, a
+ * context is dispatching and counts the samples per callback.  The
+ * result is written in the folded stack format used by flamegraph.pl,
+ * with callbacks as addresses to be symbolized with addr2line:
+ *
+ *	uev_run;0x400d2f1c 1234
+ *	uev_idle 5678
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_PROF_H
+#define LIBUEV_PROF_H
+
+#include <stdio.h>
+#include <esp_timer.h>
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Max. number of distinct callbacks, must be a power of two */
+#ifndef UEV_PROF_SLOTS
+#define UEV_PROF_SLOTS  64
+#endif
+
+/* Sampling profiler */
+typedef struct {
+	uev_ctx_t          *ctx;
+	esp_timer_handle_t  timer;
+
+	/* Open addressed table of callback addresses and sample counts */
+	atomic_uintptr_t    key[UEV_PROF_SLOTS];
+	atomic_uint         count[UEV_PROF_SLOTS];
+
+	atomic_uint         idle;	/* Samples outside of any callback */
+	atomic_uint         lost;	/* Samples not counted, table full */
+} uev_prof_t;
+
+int uev_prof_start     (uev_ctx_t *ctx, uev_prof_t *p, unsigned int period_us);
+int uev_prof_stop      (uev_prof_t *p);
+int uev_prof_dump      (uev_prof_t *p, FILE *fp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_PROF_H */
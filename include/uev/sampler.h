@@ -0,0 +1,94 @@
+/* libuEv - Fixed rate sampling into a ring drained in batches
+ *
+ * A periodic high resolution timer calls a read function at a fixed,
+ * drift-free rate, outside of the event loop.  Each sample is stored
+ * with its capture timestamp in a preallocated ring.  The consumer
+ * callback runs in the event loop once a batch of samples is ready or
+ * the oldest sample has waited for the latency bound, and gets the
+ * samples as contiguous arrays suitable for block processing.
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_SAMPLER_H
+#define LIBUEV_SAMPLER_H
+
+#include <esp_timer.h>
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Flags for uev_sampler_init() */
+#define UEV_SAMPLER_ISR  0x01	/* Call the read function from the timer ISR */
+
+struct uev_sampler;
+
+/* Read one sample into @sample, return non-zero to skip it */
+typedef int  (uev_sample_fn_t)(struct uev_sampler *s, void *arg, void *sample);
+
+/* Consume @n samples, @ts in microseconds of esp_timer_get_time() */
+typedef void (uev_sampler_cb_t)(struct uev_sampler *s, void *arg,
+				const uint64_t *ts, const void *data, size_t n);
+
+/* Sampler, producer in the timer and consumer in the event loop */
+typedef struct uev_sampler {
+	uev_t               w;
+	esp_timer_handle_t  timer;
+
+	uev_sample_fn_t    *read;
+	uev_sampler_cb_t   *cb;
+	void               *arg;
+
+	/* Single producer, single consumer ring of timestamps and samples */
+	uint64_t           *ts;
+	unsigned char      *data;
+	size_t              size;
+	size_t              mask;
+	atomic_size_t       head;
+	atomic_size_t       tail;
+
+	/* Wakeup policy, only touched by the producer after setup */
+	size_t              batch;
+	uint32_t            latency_us;
+	size_t              mark;		/* First sample not yet signalled */
+	uint64_t            mark_ts;
+
+	atomic_uint         dropped;	/* Samples lost, ring full */
+
+	/* Handshake with uev_sampler_stop(), see sampler_tick() */
+	atomic_int          stopping;
+	atomic_int          ticking;	/* Ticks in progress */
+} uev_sampler_t;
+
+int uev_sampler_init   (uev_ctx_t *ctx, uev_sampler_t *s, uev_sampler_cb_t *cb, void *arg,
+			uev_sample_fn_t *read, size_t size, size_t capacity, unsigned int period_us,
+			int flags);
+int uev_sampler_batch  (uev_sampler_t *s, size_t batch, unsigned int latency_us);
+int uev_sampler_stop   (uev_sampler_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_SAMPLER_H */
@@ -0,0 +1,76 @@
+/* libuEv - Deferred tasks shared by the contexts of a scheduler
+ *
+ * Each context attached to a scheduler owns a bounded lock-free deque
+ * of tasks.  A callback spawns tasks on its own context, which runs
+ * a slice of them after every event scan, so a busy context still gets
+ * through its deque.  A context about to block first takes a task from
+ * its own deque or steals one from a sibling, so with one context per
+ * core, spare cores absorb bursts of work.
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_SCHED_H
+#define LIBUEV_SCHED_H
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Max. number of contexts sharing a scheduler */
+#ifndef UEV_SCHED_MAX
+#define UEV_SCHED_MAX  4
+#endif
+
+/* Max. number of own tasks a context runs after each event scan */
+#ifndef UEV_SCHED_SLICE
+#define UEV_SCHED_SLICE  4
+#endif
+
+struct uev_task;
+
+/* Task function, may run in any context of the scheduler */
+typedef void (uev_task_cb_t)(struct uev_task *t, void *arg);
+
+/* Deferred task, owned by the caller until its function is called */
+typedef struct uev_task {
+	uev_task_cb_t  *cb;
+	void           *arg;
+} uev_task_t;
+
+/* Scheduler, a set of contexts stealing tasks from each other */
+typedef struct {
+	struct uev_sched_q *q[UEV_SCHED_MAX];
+	atomic_int          count;
+} uev_sched_t;
+
+int uev_sched_init     (uev_sched_t *s);
+int uev_sched_attach   (uev_sched_t *s, uev_ctx_t *ctx, size_t capacity);
+int uev_sched_detach   (uev_ctx_t *ctx);
+int uev_sched_spawn    (uev_ctx_t *ctx, uev_task_t *t, uev_task_cb_t *cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_SCHED_H */
@@ -0,0 +1,77 @@
+/* libuEv - Statistics served over UDP, requires CONFIG_UEV_STATS
+ *
+ * The server answers each request datagram with one reply datagram
+ * built in a preallocated buffer.  All integers are little endian.
+ *
+ * Request:  u8 magic 'U', u8 command, u16 first watcher index
+ * Reply:    u8 'U', u8 'S', u8 version, u8 command, payload
+ *
+ * %UEV_STATS_CMD_CTX payload:
+ *   u16 watchers by type [io, timer, threadsafe timer, event, embed]
+ *   u32 wakeups, u32 dispatches, u64 callback time us, u32 max callback us,
+ *   u32 timers fired, u64 timer lateness ms, u32 max timer lateness ms,
+ *   u32 iothread rounds, u32 last round us, u32 max round us
+ *
+ * %UEV_STATS_CMD_WATCHERS payload:
+ *   u16 total watchers, u16 first index, u8 count, then for each:
+ *   u8 type, u8 flags (1 active, 2 suspended), i16 fd, u32 callback,
+ *   u32 dispatches, u64 callback time us, u32 max callback us
+ *
+ * tools/uevstats.py is a host side client and decoder.
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_STATS_H
+#define LIBUEV_STATS_H
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UEV_STATS_MAGIC         'U'
+#define UEV_STATS_VERSION       1
+
+#define UEV_STATS_CMD_CTX       1
+#define UEV_STATS_CMD_WATCHERS  2
+
+/* Reply buffer size, bounds the number of watchers per reply */
+#ifndef UEV_STATS_BUFSZ
+#define UEV_STATS_BUFSZ         512
+#endif
+
+/* Stats server */
+typedef struct {
+	uev_t           w;
+	uint8_t         buf[UEV_STATS_BUFSZ];
+} uev_stats_t;
+
+int uev_stats_init     (uev_ctx_t *ctx, uev_stats_t *s, int fd);
+int uev_stats_stop     (uev_stats_t *s);
+int uev_stats_reset    (uev_ctx_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_STATS_H */
@@ -0,0 +1,115 @@
+/* libuEv - Publish/subscribe topics with zero-copy fan-out
+ *
+ * A publisher copies each message once into a reference counted slot
+ * of the topic.  Every subscriber gets a pointer to the slot through a
+ * lock-free queue of its own and an event watcher in its context, so
+ * subscribers of the same context share one wakeup.  Callbacks get the
+ * messages in batches.  A slot is reused once the publisher and all
+ * subscribers have released it.
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_TOPIC_H
+#define LIBUEV_TOPIC_H
+
+#include "uev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Max. number of subscribers per topic */
+#ifndef UEV_TOPIC_MAX_SUBS
+#define UEV_TOPIC_MAX_SUBS  8
+#endif
+
+/* Max. number of messages per callback */
+#ifndef UEV_TOPIC_BATCH
+#define UEV_TOPIC_BATCH     8
+#endif
+
+/* Message header, the payload follows, see uev_topic_data() */
+typedef struct {
+	atomic_int      refs;
+	size_t          len;
+} uev_topic_msg_t;
+
+#define uev_topic_data(m)  ((void *)((uev_topic_msg_t *)(m) + 1))
+
+/* Slot size for messages of up to @size bytes */
+#define UEV_TOPIC_SLOTSZ(size)							\
+	((sizeof(uev_topic_msg_t) + (size) + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1))
+
+/* Size of the buffer for a topic of @nslots messages of up to @size bytes */
+#define UEV_TOPIC_BUFSZ(nslots, size)  ((nslots) * UEV_TOPIC_SLOTSZ(size))
+
+struct uev_topic_sub;
+
+/* Topic, shared by publishers and subscribers in any context */
+typedef struct {
+	unsigned char  *buf;
+	size_t          nslots;
+	size_t          size;
+	atomic_size_t   hint;		/* Where to look for a free slot */
+
+	atomic_uintptr_t subs[UEV_TOPIC_MAX_SUBS];
+
+	/*
+	 * Publishes in progress on each subscriber slot, counted in one of
+	 * two halves by the epoch they started in.  Unsubscribing flips the
+	 * epoch and waits only for the half of the old one.
+	 */
+	atomic_uint     epoch[UEV_TOPIC_MAX_SUBS];
+	atomic_int      busy[UEV_TOPIC_MAX_SUBS][2];
+
+	atomic_uint     dropped;	/* Messages lost, no free slot */
+} uev_topic_t;
+
+typedef void (uev_topic_cb_t)(struct uev_topic_sub *s, void *arg, uev_topic_msg_t **msgs, size_t n);
+
+/* Subscription, lives in the context of its callback */
+typedef struct uev_topic_sub {
+	uev_t           w;
+	uev_topic_t    *topic;
+	struct uev_mpq *q;
+
+	uev_topic_cb_t *cb;
+	void           *arg;
+
+	atomic_uint     dropped;	/* Messages lost, queue full */
+} uev_topic_sub_t;
+
+int uev_topic_init        (uev_topic_t *t, void *buf, size_t nslots, size_t size);
+int uev_topic_publish     (uev_topic_t *t, const void *data, size_t len);
+
+int uev_topic_subscribe   (uev_ctx_t *ctx, uev_topic_t *t, uev_topic_sub_t *s,
+			   uev_topic_cb_t *cb, void *arg, size_t depth);
+int uev_topic_unsubscribe (uev_topic_sub_t *s);
+
+int uev_topic_retain      (uev_topic_msg_t *m);
+int uev_topic_release     (uev_topic_msg_t *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUEV_TOPIC_H */
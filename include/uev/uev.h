@@ -27,6 +27,10 @@
 
 #include "private.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Max. number of simulateneous events */
 #define UEV_MAX_EVENTS  10
 
@@ -47,9 +51,10 @@
 #define uev_io_active(w)     _uev_watcher_active(w)
 #define uev_timer_active(w)  _uev_watcher_active(w)
 #define uev_event_active(w)  _uev_watcher_active(w)
+#define uev_embed_active(w)  _uev_watcher_active(w)
 
 /* Event watcher */
-typedef struct uev {
+typedef struct _UEV_WATCHER {
 	/* Private data for libuEv internal engine */
 	uev_private_t   type;
 
@@ -58,6 +63,13 @@ typedef struct uev {
 	uev_ctx_t      *ctx;
 } uev_t;
 
+/* Watcher group, see uev_group_init() */
+typedef struct uev_group {
+	uev_ctx_t            *ctx;
+	struct uev_list_node  members;
+	atomic_int            suspended;
+} uev_group_t;
+
 /*
  * Generic callback for watchers, @events holds %UEV_READ and/or %UEV_WRITE
  * with optional %UEV_PRI (priority data available to read) and any of the
@@ -74,9 +86,14 @@ typedef void (uev_cb_t)(uev_t *w, void *arg, int events);
 int uev_init           (uev_ctx_t *ctx);
 int uev_exit           (uev_ctx_t *ctx);
 int uev_run            (uev_ctx_t *ctx, int flags);
+int uev_run_for        (uev_ctx_t *ctx, unsigned int budget_us, unsigned int max_callbacks);
+
+int uev_mem_limit      (uev_ctx_t *ctx, size_t limit);
+int uev_mem_usage      (uev_ctx_t *ctx, size_t *used, size_t *peak);
 
 int uev_io_init        (uev_ctx_t *ctx, uev_t *w, uev_cb_t *cb, void *arg, int fd, int events);
 int uev_io_set         (uev_t *w, int fd, int events);
+int uev_io_modify      (uev_t *w, int events);
 int uev_io_start       (uev_t *w);
 int uev_io_stop        (uev_t *w);
 int uev_iothread_init  (void);
@@ -91,4 +108,19 @@ int uev_event_init     (uev_ctx_t *ctx, uev_t *w, uev_cb_t *cb, void *arg);
 int uev_event_post     (uev_t *w);
 int uev_event_stop     (uev_t *w);
 
+int uev_embed_init     (uev_ctx_t *ctx, uev_t *w, uev_cb_t *cb, void *arg, uev_ctx_t *child);
+int uev_embed_sweep    (uev_t *w);
+int uev_embed_stop     (uev_t *w);
+
+int uev_group_init     (uev_ctx_t *ctx, uev_group_t *g);
+int uev_group_add      (uev_group_t *g, uev_t *w);
+int uev_group_del      (uev_t *w);
+int uev_group_suspend  (uev_group_t *g);
+int uev_group_resume   (uev_group_t *g);
+int uev_group_stop     (uev_group_t *g);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* LIBUEV_UEV_H */
@@ -0,0 +1,199 @@
+/* libuEv - Header-only C++ interface
+ *
+ * RAII wrappers for contexts and watchers.  Callbacks are stored inline
+ * in the watcher object and bound at compile time, so there is no heap
+ * allocation and a dispatch is a single call through a static
+ * trampoline, the same as a plain C callback.  Requires C++17.
+ *
+ * Example:
+ *
+ *	uev::Context ctx;
+ *	uev::Timer timer(ctx, [](int events) { ... }, 100, 100);
+ *	ctx.run();
+ *
+ * Watchers must be destroyed before the context they are registered
+ * to, declaring the context first takes care of that.
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_UEV_HPP
+#define LIBUEV_UEV_HPP
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "uev.h"
+
+namespace uev {
+
+/* Event loop context */
+class Context {
+public:
+	Context() noexcept { rc_ = uev_init(&ctx_); }
+	~Context() { uev_exit(&ctx_); }
+
+	Context(const Context &) = delete;
+	Context &operator=(const Context &) = delete;
+
+	explicit operator bool() const noexcept { return rc_ == 0; }
+	operator uev_ctx_t *() noexcept { return &ctx_; }
+	uev_ctx_t *get() noexcept { return &ctx_; }
+
+	int run(int flags = 0) noexcept { return uev_run(&ctx_, flags); }
+
+private:
+	uev_ctx_t ctx_;
+	int       rc_;
+};
+
+/*
+ * Bind a member function at compile time,
+ * e.g. uev::Member<&Session::on_read>(this)
+ */
+template <auto Fn>
+class Member;
+
+template <class T, void (T::*Fn)(int)>
+class Member<Fn> {
+public:
+	explicit Member(T *obj) noexcept : obj_(obj) {}
+	void operator()(int events) const { (obj_->*Fn)(events); }
+
+private:
+	T *obj_;
+};
+
+namespace detail {
+
+/* Common base, owns the C watcher */
+class Watcher {
+public:
+	Watcher(const Watcher &) = delete;
+	Watcher &operator=(const Watcher &) = delete;
+
+	explicit operator bool() const noexcept { return rc_ == 0; }
+	uev_t *get() noexcept { return &w_; }
+	int fd() const noexcept { return w_.fd; }
+	bool active() noexcept { return _uev_watcher_active(&w_); }
+
+protected:
+	Watcher() noexcept { std::memset(static_cast<void *>(&w_), 0, sizeof(w_)); }
+	~Watcher() = default;
+
+	/* In a union since the atomics in uev_t make it non-constructible in C++ */
+	union {
+		uev_t w_;
+	};
+	int rc_ = 0;
+};
+
+/* Call @fn with the watcher itself if it takes it, otherwise only the events */
+template <class F, class W>
+inline void invoke(F &fn, W &w, int events)
+{
+	if constexpr (std::is_invocable_v<F &, W &, int>)
+		fn(w, events);
+	else
+		fn(events);
+}
+
+} /* namespace detail */
+
+/* Timer watcher, time in milliseconds */
+template <class F>
+class Timer : public detail::Watcher {
+public:
+	Timer(uev_ctx_t *ctx, F fn, int timeout, int period = 0, bool threadsafe = false)
+		: fn_(std::move(fn))
+	{
+		rc_ = uev_timer_init2(ctx, &w_, &trampoline, this, timeout, period, threadsafe);
+	}
+	~Timer() { uev_timer_stop(&w_); }
+
+	int set(int timeout, int period = 0) noexcept { return uev_timer_set(&w_, timeout, period); }
+	int start() noexcept { return uev_timer_start(&w_); }
+	int stop() noexcept { return uev_timer_stop(&w_); }
+
+private:
+	static void trampoline(uev_t *, void *arg, int events)
+	{
+		Timer *self = static_cast<Timer *>(arg);
+		detail::invoke(self->fn_, *self, events);
+	}
+
+	F fn_;
+};
+
+/* I/O watcher, @events is a mask of %UEV_READ and %UEV_WRITE */
+template <class F>
+class Io : public detail::Watcher {
+public:
+	Io(uev_ctx_t *ctx, F fn, int fd, int events)
+		: fn_(std::move(fn))
+	{
+		rc_ = uev_io_init(ctx, &w_, &trampoline, this, fd, events);
+	}
+	~Io() { uev_io_stop(&w_); }
+
+	int set(int fd, int events) noexcept { return uev_io_set(&w_, fd, events); }
+	int modify(int events) noexcept { return uev_io_modify(&w_, events); }
+	int start() noexcept { return uev_io_start(&w_); }
+	int stop() noexcept { return uev_io_stop(&w_); }
+
+private:
+	static void trampoline(uev_t *, void *arg, int events)
+	{
+		Io *self = static_cast<Io *>(arg);
+		detail::invoke(self->fn_, *self, events);
+	}
+
+	F fn_;
+};
+
+/* Generic event watcher, post() is safe from other tasks and interrupts */
+template <class F>
+class Event : public detail::Watcher {
+public:
+	Event(uev_ctx_t *ctx, F fn)
+		: fn_(std::move(fn))
+	{
+		rc_ = uev_event_init(ctx, &w_, &trampoline, this);
+	}
+	~Event() { uev_event_stop(&w_); }
+
+	int post() noexcept { return uev_event_post(&w_); }
+	int stop() noexcept { return uev_event_stop(&w_); }
+
+private:
+	static void trampoline(uev_t *, void *arg, int events)
+	{
+		Event *self = static_cast<Event *>(arg);
+		detail::invoke(self->fn_, *self, events);
+	}
+
+	F fn_;
+};
+
+} /* namespace uev */
+
+#endif /* LIBUEV_UEV_HPP */
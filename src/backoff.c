@@ -0,0 +1,411 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <esp_system.h>		/* esp_random() */
+
+#include <uev/backoff.h>
+
+#define NOT_QUEUED SIZE_MAX
+
+static uint32_t backoff_rand(uev_backoff_t *b)
+{
+	uint32_t x = b->seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	b->seed = x;
+
+	return x;
+}
+
+/* Random number in [lo, hi] */
+static unsigned int backoff_between(uev_backoff_t *b, unsigned int lo, unsigned int hi)
+{
+	if (hi <= lo)
+		return lo;
+
+	return lo + backoff_rand(b) % (hi - lo + 1);
+}
+
+/* Delay before attempt number r->attempt + 1 */
+static unsigned int backoff_delay(uev_retry_t *r)
+{
+	uint64_t exp = r->base;
+	unsigned int n;
+
+	for (n = 0; n < r->attempt && exp < r->max; n++)
+		exp <<= 1;
+	if (exp > r->max)
+		exp = r->max;
+
+	switch (r->policy) {
+	case UEV_BACKOFF_FULL_JITTER:
+		return backoff_between(r->b, 0, (unsigned int)exp);
+
+	case UEV_BACKOFF_DECORRELATED: {
+		uint64_t hi = (uint64_t)(r->delay ? r->delay : r->base) * 3;
+
+		if (hi > r->max)
+			hi = r->max;
+		return backoff_between(r->b, r->base, (unsigned int)hi);
+	}
+
+	default:
+		return (unsigned int)exp;
+	}
+}
+
+static void heap_set(uev_backoff_t *b, size_t i, uev_retry_t *r)
+{
+	b->heap[i] = r;
+	r->pos = i;
+}
+
+static void heap_up(uev_backoff_t *b, size_t i)
+{
+	uev_retry_t *r = b->heap[i];
+
+	while (i > 0) {
+		size_t parent = (i - 1) / 2;
+
+		if (b->heap[parent]->due <= r->due)
+			break;
+
+		heap_set(b, i, b->heap[parent]);
+		i = parent;
+	}
+
+	heap_set(b, i, r);
+}
+
+static void heap_down(uev_backoff_t *b, size_t i)
+{
+	uev_retry_t *r = b->heap[i];
+
+	for (;;) {
+		size_t child = 2 * i + 1;
+
+		if (child >= b->count)
+			break;
+		if (child + 1 < b->count && b->heap[child + 1]->due < b->heap[child]->due)
+			child++;
+		if (r->due <= b->heap[child]->due)
+			break;
+
+		heap_set(b, i, b->heap[child]);
+		i = child;
+	}
+
+	heap_set(b, i, r);
+}
+
+static void heap_remove(uev_backoff_t *b, uev_retry_t *r)
+{
+	size_t i = r->pos;
+	uev_retry_t *last = b->heap[--b->count];
+
+	r->pos = NOT_QUEUED;
+	if (last == r)
+		return;
+
+	heap_set(b, i, last);
+	heap_up(b, i);
+	heap_down(b, last->pos);
+}
+
+/* Arm the timer for the earliest retry, if any */
+static void backoff_arm(uev_backoff_t *b, uint64_t now)
+{
+	uint64_t due;
+
+	if (!b->count) {
+		uev_timer_stop(&b->w);
+		return;
+	}
+
+	due = b->heap[0]->due;
+	uev_timer_set(&b->w, due > now ? (int)(due - now) : 1, 0);
+}
+
+static void backoff_cb(uev_t *w, void *arg, int events)
+{
+	uev_backoff_t *b = (uev_backoff_t *)arg;
+	uev_ctx_t *ctx = w->ctx;
+	uint64_t now = _uev_timer_now() / 1000;
+
+	if (events & UEV_ERROR)
+		return;
+
+	while (b->count && b->heap[0]->due <= now) {
+		uev_retry_t *r = b->heap[0];
+
+		heap_remove(b, r);
+		r->cb(r, r->arg, r->attempt);
+
+		/* Stopped from the callback, do not touch @b */
+		if (ctx->current != w)
+			return;
+	}
+
+	backoff_arm(b, now);
+}
+
+/**
+ * Create a backoff scheduler
+ * @param ctx       A valid libuEv context
+ * @param b         Pointer to an uev_backoff_t scheduler
+ * @param capacity  Max. number of retries pending at once
+ *
+ * The heap is allocated from @param ctx.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_backoff_init(uev_ctx_t *ctx, uev_backoff_t *b, size_t capacity)
+{
+	if (!ctx || !b || !capacity) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	b->heap = _uev_malloc(ctx, capacity * sizeof(b->heap[0]));
+	if (!b->heap)
+		return -1;
+
+	b->capacity = capacity;
+	b->count    = 0;
+	/* Not the time, devices booted together must not retry in step */
+	b->seed     = esp_random() | 1;
+
+	/* Only armed while retries are pending */
+	if (uev_timer_init(ctx, &b->w, backoff_cb, b, 0, 0) || uev_timer_stop(&b->w)) {
+		_uev_free(ctx, b->heap, capacity * sizeof(b->heap[0]));
+		b->heap = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Stop a backoff scheduler
+ * @param b  Scheduler to stop
+ *
+ * Pending retries are cancelled without calling their callbacks.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_backoff_stop(uev_backoff_t *b)
+{
+	size_t i;
+
+	if (!b || !b->heap) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < b->count; i++)
+		b->heap[i]->pos = NOT_QUEUED;
+
+	uev_timer_stop(&b->w);
+	_uev_free(b->w.ctx, b->heap, b->capacity * sizeof(b->heap[0]));
+	b->heap  = NULL;
+	b->count = 0;
+
+	return 0;
+}
+
+/**
+ * Create the retry state of a client
+ * @param b       A valid backoff scheduler
+ * @param r       Pointer to an uev_retry_t
+ * @param cb      Callback when it is time for the next attempt
+ * @param arg     Optional callback argument
+ * @param policy  One of %UEV_BACKOFF_EXP, %UEV_BACKOFF_FULL_JITTER or %UEV_BACKOFF_DECORRELATED
+ * @param base    Base delay in milliseconds
+ * @param max     Max. delay in milliseconds
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_retry_init(uev_backoff_t *b, uev_retry_t *r, uev_retry_cb_t *cb, void *arg,
+		   int policy, unsigned int base, unsigned int max)
+{
+	if (!b || !r || !cb || !base || max < base || max > INT32_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (policy != UEV_BACKOFF_EXP && policy != UEV_BACKOFF_FULL_JITTER &&
+	    policy != UEV_BACKOFF_DECORRELATED) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	r->b      = b;
+	r->cb     = cb;
+	r->arg    = arg;
+	r->policy = policy;
+	r->base   = base;
+	r->max    = max;
+	r->max_attempts = 0;
+	r->budget = 0;
+	r->pos    = NOT_QUEUED;
+
+	return uev_retry_reset(r);
+}
+
+/**
+ * Limit the retries of a client
+ * @param r             A valid retry state
+ * @param max_attempts  Max. number of attempts, or zero for no limit
+ * @param budget        Max. time in milliseconds from the first retry, or zero for no limit
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_retry_limit(uev_retry_t *r, unsigned int max_attempts, unsigned int budget)
+{
+	if (!r) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	r->max_attempts = max_attempts;
+	r->budget = budget;
+
+	return 0;
+}
+
+/**
+ * Schedule the next attempt
+ * @param r  A valid retry state
+ *
+ * Call after a failed attempt.  The delay grows with each call
+ * according to the policy of @param r, until uev_retry_reset().
+ * A retry already pending is rescheduled.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %ETIMEDOUT when the attempts or the time budget are used up and the
+ * client should give up, %ENOSPC when the scheduler is full.
+ */
+int uev_retry_schedule(uev_retry_t *r)
+{
+	uev_backoff_t *b;
+	unsigned int delay;
+	uint64_t now;
+
+	if (!r || !r->b || !r->b->heap) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	b = r->b;
+	if (r->max_attempts && r->attempt >= r->max_attempts) {
+		errno = ETIMEDOUT;
+		return -1;
+	}
+
+	now = _uev_timer_now() / 1000;
+	if (!r->attempt)
+		r->started = now;
+
+	delay = backoff_delay(r);
+	if (r->budget && now + delay - r->started > r->budget) {
+		errno = ETIMEDOUT;
+		return -1;
+	}
+
+	if (r->pos == NOT_QUEUED && b->count == b->capacity) {
+		errno = ENOSPC;
+		return -1;
+	}
+
+	r->attempt++;
+	r->delay = delay;
+	r->due   = now + delay;
+
+	if (r->pos == NOT_QUEUED) {
+		heap_set(b, b->count++, r);
+		heap_up(b, r->pos);
+	} else {
+		heap_up(b, r->pos);
+		heap_down(b, r->pos);
+	}
+
+	if (b->heap[0] == r)
+		backoff_arm(b, now);
+
+	return 0;
+}
+
+/**
+ * Cancel a pending retry
+ * @param r  A valid retry state
+ *
+ * The attempt count is kept, see uev_retry_reset().
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_retry_cancel(uev_retry_t *r)
+{
+	uev_backoff_t *b;
+	int first;
+
+	if (!r || !r->b) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (r->pos == NOT_QUEUED)
+		return 0;
+
+	b = r->b;
+	first = r->pos == 0;
+	heap_remove(b, r);
+	if (first)
+		backoff_arm(b, _uev_timer_now() / 1000);
+
+	return 0;
+}
+
+/**
+ * Reset the retry state after a successful attempt
+ * @param r  A valid retry state
+ *
+ * Cancels any pending retry and starts over from the base delay.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_retry_reset(uev_retry_t *r)
+{
+	if (uev_retry_cancel(r))
+		return -1;
+
+	r->attempt = 0;
+	r->delay   = 0;
+	r->started = 0;
+	r->due     = 0;
+
+	return 0;
+}
@@ -0,0 +1,239 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <uev/co.h>
+
+/* Release whatever the coroutine's watcher is currently used for */
+static void co_disarm(uev_co_t *co)
+{
+	switch (co->w.type) {
+	case UEV_IO_TYPE:
+		uev_io_stop(&co->w);
+		break;
+
+	case UEV_TIMER_TYPE:
+		uev_timer_stop(&co->w);
+		break;
+
+	case UEV_EVENT_TYPE:
+		uev_event_stop(&co->w);
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void co_resume(uev_co_t *co, int events)
+{
+	co->wait   = 0;
+	co->events = events;
+
+	if (co->fn(co, co->arg) == UEV_CO_DONE) {
+		co->lc = -1;
+		co_disarm(co);
+		uev_event_stop(&co->ev);
+	}
+}
+
+static void co_cb(uev_t *w, void *arg, int events)
+{
+	uev_co_t *co = (uev_co_t *)arg;
+
+	(void)w;
+	if (co->wait != UEV_CO_WAIT_IO && co->wait != UEV_CO_WAIT_TIMER)
+		return;
+
+	co_resume(co, events);
+}
+
+static void co_post_cb(uev_t *w, void *arg, int events)
+{
+	uev_co_t *co = (uev_co_t *)arg;
+
+	(void)w;
+	if (co->wait != UEV_CO_WAIT_EVENT)
+		return;
+
+	if (!atomic_exchange(&co->posted, 0))
+		return;
+
+	co_resume(co, events);
+}
+
+/* Private to libuEv, do not use directly! */
+int _uev_co_io(uev_co_t *co, int fd, int events)
+{
+	co->wait = UEV_CO_WAIT_IO;
+
+	/* Waiting on the same thing again keeps the watcher as it is */
+	if (co->w.type == UEV_IO_TYPE && uev_io_active(&co->w) &&
+	    co->w.fd == fd && co->w.events == events)
+		return 0;
+
+	co_disarm(co);
+	if (uev_io_init(co->w.ctx, &co->w, co_cb, co, fd, events)) {
+		co->wait = 0;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * A zero @timeout would disarm the timer and never resume us, so it
+ * yields once instead, through an event watcher posted to ourselves.
+ */
+int _uev_co_timer(uev_co_t *co, int timeout)
+{
+	co->wait = UEV_CO_WAIT_TIMER;
+
+	if (!timeout) {
+		if (co->w.type != UEV_EVENT_TYPE || !uev_event_active(&co->w)) {
+			co_disarm(co);
+			if (uev_event_init(co->w.ctx, &co->w, co_cb, co)) {
+				co->wait = 0;
+				return -1;
+			}
+		}
+
+		if (uev_event_post(&co->w)) {
+			co->wait = 0;
+			return -1;
+		}
+
+		return 0;
+	}
+
+	co_disarm(co);
+	if (uev_timer_init(co->w.ctx, &co->w, co_cb, co, timeout, 0)) {
+		co->wait = 0;
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Private to libuEv, do not use directly! */
+int _uev_co_event(uev_co_t *co)
+{
+	co->wait = UEV_CO_WAIT_EVENT;
+
+	/* Posts arrive on co->ev, nothing else may resume us meanwhile */
+	co_disarm(co);
+
+	/* Posted while we were busy, carry on right away */
+	if (atomic_exchange(&co->posted, 0)) {
+		co->wait = 0;
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Start a coroutine
+ * @param ctx  A valid libuEv context
+ * @param co   Pointer to an uev_co_t coroutine frame
+ * @param fn   Coroutine function
+ * @param arg  Coroutine state, passed to every invocation of @param fn
+ *
+ * The coroutine runs right away until it first waits, and is then
+ * resumed from uev_run() each time what it waits for is ready.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_co_start(uev_ctx_t *ctx, uev_co_t *co, uev_co_fn_t *fn, void *arg)
+{
+	if (!ctx || !co || !fn) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	memset(co, 0, sizeof(*co));
+	co->w.ctx = ctx;
+	co->w.fd  = -1;
+	co->fn    = fn;
+	co->arg   = arg;
+	atomic_init(&co->posted, 0);
+
+	if (uev_event_init(ctx, &co->ev, co_post_cb, co))
+		return -1;
+
+	co_resume(co, 0);
+
+	return 0;
+}
+
+/**
+ * Cancel a coroutine
+ * @param co  Coroutine to cancel
+ *
+ * The coroutine is not resumed again, any state in its argument is
+ * left for the caller to clean up.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_co_stop(uev_co_t *co)
+{
+	if (!co) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	co->lc   = -1;
+	co->wait = 0;
+	co_disarm(co);
+	uev_event_stop(&co->ev);
+
+	return 0;
+}
+
+/**
+ * Wake up a coroutine waiting in UEV_CO_EVENT()
+ * @param co  Coroutine to post to
+ *
+ * Safe to call from other tasks and interrupts, between uev_co_start()
+ * and the coroutine finishing or being stopped.  Posts go through an
+ * event watcher of their own, which the loop never re-purposes.  A post
+ * made while the coroutine is not waiting is remembered until its next
+ * UEV_CO_EVENT().
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_co_post(uev_co_t *co)
+{
+	if (!co) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	atomic_store(&co->posted, 1);
+
+	return uev_event_post(&co->ev);
+}
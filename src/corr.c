@@ -0,0 +1,298 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+
+#include <uev/corr.h>
+
+static inline size_t corr_home(uev_corr_t *c, uint32_t id)
+{
+	return (size_t)(id * 0x9e3779b1u) & c->mask;
+}
+
+/* Index slot holding @id, or the empty slot ending its probe sequence */
+static size_t corr_slot(uev_corr_t *c, uint32_t id)
+{
+	size_t i = corr_home(c, id);
+
+	while (c->index[i] && c->index[i]->id != id)
+		i = (i + 1) & c->mask;
+
+	return i;
+}
+
+/* Backward shift deletion, keeps probe sequences intact without tombstones */
+static void corr_unindex(uev_corr_t *c, size_t i)
+{
+	size_t j = i;
+
+	for (;;) {
+		size_t k;
+
+		j = (j + 1) & c->mask;
+		if (!c->index[j])
+			break;
+
+		/* Move it back unless its home lies in (i, j] */
+		k = corr_home(c, c->index[j]->id);
+		if (((j - k) & c->mask) >= ((j - i) & c->mask)) {
+			c->index[i] = c->index[j];
+			i = j;
+		}
+	}
+
+	c->index[i] = NULL;
+}
+
+static void corr_unlink(uev_corr_t *c, uev_corr_entry_t *e)
+{
+	if (e->prev)
+		e->prev->next = e->next;
+	else
+		c->head = e->next;
+	if (e->next)
+		e->next->prev = e->prev;
+	else
+		c->tail = e->prev;
+
+	e->next = c->free;
+	c->free = e;
+	c->count--;
+}
+
+/* Arm the timer for the oldest request, if any */
+static void corr_arm(uev_corr_t *c, uint64_t now)
+{
+	uint64_t deadline;
+
+	if (!c->head)
+		return;
+
+	deadline = c->head->deadline;
+	uev_timer_set(&c->w, deadline > now ? (int)(deadline - now) : 1, 0);
+}
+
+static void corr_cb(uev_t *w, void *arg, int events)
+{
+	uev_corr_t *c = (uev_corr_t *)arg;
+	uev_ctx_t *ctx = w->ctx;
+	uint64_t now = _uev_timer_now() / 1000;
+
+	if (events & UEV_ERROR)
+		return;
+
+	while (c->head && c->head->deadline <= now) {
+		uev_corr_entry_t *e = c->head;
+		uint32_t id = e->id;
+		void *data = e->data;
+
+		corr_unindex(c, corr_slot(c, id));
+		corr_unlink(c, e);
+
+		c->cb(c, c->arg, id, data);
+
+		/* Stopped from the callback, do not touch @c */
+		if (ctx->current != w)
+			return;
+	}
+
+	/* Completed requests are skipped lazily, here */
+	if (!uev_timer_active(w))
+		corr_arm(c, now);
+}
+
+/**
+ * Create a correlation table
+ * @param ctx       A valid libuEv context
+ * @param c         Pointer to an uev_corr_t table
+ * @param cb        Callback when a request times out
+ * @param arg       Optional callback argument
+ * @param capacity  Max. number of requests in flight
+ * @param timeout   Timeout in milliseconds for every request
+ *
+ * The entry pool and index are allocated from @param ctx.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_corr_init(uev_ctx_t *ctx, uev_corr_t *c, uev_corr_cb_t *cb, void *arg,
+		  size_t capacity, int timeout)
+{
+	size_t size = 2, i;
+
+	if (!ctx || !c || !cb || !capacity || timeout <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Keep the index at most half full */
+	while (size < 2 * capacity)
+		size <<= 1;
+
+	c->pool = _uev_malloc(ctx, capacity * sizeof(c->pool[0]) + size * sizeof(c->index[0]));
+	if (!c->pool)
+		return -1;
+
+	c->index    = (uev_corr_entry_t **)(c->pool + capacity);
+	c->capacity = capacity;
+	c->mask     = size - 1;
+	c->count    = 0;
+	c->cb       = cb;
+	c->arg      = arg;
+	c->timeout  = timeout;
+	c->head     = c->tail = NULL;
+
+	c->free = NULL;
+	for (i = capacity; i > 0; i--) {
+		c->pool[i - 1].next = c->free;
+		c->free = &c->pool[i - 1];
+	}
+	for (i = 0; i < size; i++)
+		c->index[i] = NULL;
+
+	/* Only armed while requests are in flight */
+	if (uev_timer_init(ctx, &c->w, corr_cb, c, 0, 0) || uev_timer_stop(&c->w)) {
+		_uev_free(ctx, c->pool, capacity * sizeof(c->pool[0]) + size * sizeof(c->index[0]));
+		c->pool = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Track a new request
+ * @param c     A valid correlation table
+ * @param id    Request ID, unique among the requests in flight
+ * @param data  Optional request data, handed back on completion or timeout
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %EEXIST if @param id is already in flight or %ENOSPC if the table is
+ * full.
+ */
+int uev_corr_insert(uev_corr_t *c, uint32_t id, void *data)
+{
+	uev_corr_entry_t *e;
+	uint64_t now;
+	size_t i;
+
+	if (!c || !c->pool) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	i = corr_slot(c, id);
+	if (c->index[i]) {
+		errno = EEXIST;
+		return -1;
+	}
+
+	e = c->free;
+	if (!e) {
+		errno = ENOSPC;
+		return -1;
+	}
+	c->free = e->next;
+
+	now = _uev_timer_now() / 1000;
+	e->id       = id;
+	e->data     = data;
+	e->deadline = now + c->timeout;
+
+	/* Same timeout for all, so the newest expires last */
+	e->next = NULL;
+	e->prev = c->tail;
+	if (c->tail)
+		c->tail->next = e;
+	else
+		c->head = e;
+	c->tail = e;
+
+	c->index[i] = e;
+	c->count++;
+
+	if (!uev_timer_active(&c->w))
+		corr_arm(c, now);
+
+	return 0;
+}
+
+/**
+ * Complete a request
+ * @param c     A valid correlation table
+ * @param id    Request ID, e.g. from a response
+ * @param data  Optional pointer to return the request data in
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %ENOENT if @param id is not in flight, e.g. it already timed out.
+ */
+int uev_corr_complete(uev_corr_t *c, uint32_t id, void **data)
+{
+	uev_corr_entry_t *e;
+	size_t i;
+
+	if (!c || !c->pool) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	i = corr_slot(c, id);
+	e = c->index[i];
+	if (!e) {
+		errno = ENOENT;
+		return -1;
+	}
+
+	if (data)
+		*data = e->data;
+
+	corr_unindex(c, i);
+	corr_unlink(c, e);
+
+	return 0;
+}
+
+/**
+ * Stop a correlation table
+ * @param c  Table to stop
+ *
+ * Requests still in flight are dropped without calling the callback.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_corr_stop(uev_corr_t *c)
+{
+	if (!c || !c->pool) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	uev_timer_stop(&c->w);
+	_uev_free(c->w.ctx, c->pool, c->capacity * sizeof(c->pool[0]) +
+		  (c->mask + 1) * sizeof(c->index[0]));
+	c->pool = NULL;
+	c->index = NULL;
+	c->head = c->tail = c->free = NULL;
+	c->count = 0;
+
+	return 0;
+}
@@ -0,0 +1,126 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+
+#include <uev/uev.h>
+
+/* Private to libuEv, do not use directly! */
+int _uev_embed_pending(uev_ctx_t *child)
+{
+	/* Not started yet, its dormant timers need arming */
+	if (!atomic_load(&child->running))
+		return 1;
+
+	if (child->pending)
+		return 1;
+
+	if (xEventGroupGetBits(child->egh) & UEV_EG_MASK)
+		return 1;
+
+	return _uev_timer_now() / 1000 > child->next_deadline;
+}
+
+/**
+ * Create an embed watcher
+ * @param ctx    A valid libuEv context
+ * @param w      Pointer to an uev_t watcher
+ * @param cb     Callback when @param child has pending work, or NULL
+ * @param arg    Optional callback argument
+ * @param child  Context to embed in @param ctx
+ *
+ * Runs @param child from the event loop of @param ctx, so several
+ * contexts can share one task.  The child keeps its own watchers and
+ * any wakeup of the child also wakes up the parent.
+ *
+ * Without a callback the child is run by the parent whenever it has
+ * pending work.  With a callback, the callback is responsible for
+ * calling uev_embed_sweep(), e.g. after some bookkeeping of its own.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_embed_init(uev_ctx_t *ctx, uev_t *w, uev_cb_t *cb, void *arg, uev_ctx_t *child)
+{
+	if (!child || child == ctx || !child->egh) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (child->embed) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	if (_uev_watcher_init(ctx, w, UEV_EMBED_TYPE, cb, arg, -1, UEV_READ))
+		return -1;
+
+	w->u.c.ctx = child;
+	if (_uev_watcher_start(w))
+		return -1;
+
+	child->embed = w;
+
+	/* Give the child its first run */
+	_uev_set_flags(ctx, UEV_EG_BIT_EMBED);
+
+	return 0;
+}
+
+/**
+ * Run an embedded context
+ * @param w  Embed watcher
+ *
+ * Serves all pending work of the embedded context without blocking.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_embed_sweep(uev_t *w)
+{
+	if (!w || w->type != UEV_EMBED_TYPE) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return uev_run(w->u.c.ctx, UEV_ONCE | UEV_NONBLOCK);
+}
+
+/**
+ * Stop an embed watcher
+ * @param w  Watcher to stop
+ *
+ * The child context is left as is and can be run on its own again.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_embed_stop(uev_t *w)
+{
+	if (!_uev_watcher_active(w))
+		return 0;
+
+	w->u.c.ctx->embed = NULL;
+
+	if (_uev_watcher_stop(w))
+		return -1;
+
+	return 0;
+}
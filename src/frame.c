@@ -0,0 +1,312 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include <uev/frame.h>
+
+static inline uint8_t frame_byte(uev_frame_t *f, size_t pos)
+{
+	return f->buf[pos & (f->size - 1)];
+}
+
+/* Describe @len bytes starting at ring position @pos as one or two spans */
+static void frame_view(uev_frame_t *f, size_t pos, size_t len, uev_frame_view_t *v)
+{
+	size_t off = pos & (f->size - 1);
+	size_t first = f->size - off;
+
+	v->ptr[0] = f->buf + off;
+	if (len <= first) {
+		v->len[0] = len;
+		v->ptr[1] = NULL;
+		v->len[1] = 0;
+	} else {
+		v->len[0] = first;
+		v->ptr[1] = f->buf;
+		v->len[1] = len - first;
+	}
+}
+
+static size_t frame_memchr(uev_frame_t *f, size_t from, size_t to)
+{
+	uev_frame_view_t v;
+	uint8_t *p;
+
+	frame_view(f, from, to - from, &v);
+
+	p = memchr(v.ptr[0], (int)f->param, v.len[0]);
+	if (p)
+		return from + (size_t)(p - v.ptr[0]);
+
+	if (v.len[1]) {
+		p = memchr(v.ptr[1], (int)f->param, v.len[1]);
+		if (p)
+			return from + v.len[0] + (size_t)(p - v.ptr[1]);
+	}
+
+	return to;
+}
+
+/*
+ * Find the next complete frame in the ring.  Returns 1 with @v and
+ * @consume set, 0 if more data is needed or -1 if the frame can never
+ * fit the ring.
+ */
+static int frame_next(uev_frame_t *f, uev_frame_view_t *v, size_t *consume)
+{
+	size_t avail = f->tail - f->head;
+	size_t len, pos;
+	size_t i;
+
+	switch (f->mode) {
+	case UEV_FRAME_FIXED:
+		if (avail < f->param)
+			return 0;
+
+		frame_view(f, f->head, f->param, v);
+		*consume = f->param;
+		return 1;
+
+	case UEV_FRAME_LENPFX:
+		if (avail < f->param)
+			return 0;
+
+		for (len = 0, i = 0; i < f->param; i++)
+			len = (len << 8) | frame_byte(f, f->head + i);
+
+		if (len > f->size - f->param)
+			return -1;
+		if (avail - f->param < len)
+			return 0;
+
+		frame_view(f, f->head + f->param, len, v);
+		*consume = f->param + len;
+		return 1;
+
+	case UEV_FRAME_DELIM:
+		if (f->scan < f->head)
+			f->scan = f->head;
+
+		pos = frame_memchr(f, f->scan, f->tail);
+		if (pos == f->tail) {
+			f->scan = f->tail;
+			if (avail == f->size)
+				return -1;
+			return 0;
+		}
+
+		frame_view(f, f->head, pos - f->head, v);
+		*consume = pos - f->head + 1;
+		return 1;
+	}
+
+	return -1;
+}
+
+/* Fill the free part of the ring, wrapping with a single readv() */
+static ssize_t frame_fill(uev_frame_t *f)
+{
+	uev_frame_view_t v;
+	struct iovec iov[2];
+	ssize_t nbytes;
+
+	frame_view(f, f->tail, f->size - (f->tail - f->head), &v);
+	iov[0].iov_base = (void *)v.ptr[0];
+	iov[0].iov_len  = v.len[0];
+	iov[1].iov_base = (void *)v.ptr[1];
+	iov[1].iov_len  = v.len[1];
+
+	do {
+		nbytes = readv(f->w.fd, iov, v.len[1] ? 2 : 1);
+	} while (nbytes < 0 && errno == EINTR);
+
+	if (nbytes > 0)
+		f->tail += (size_t)nbytes;
+
+	return nbytes;
+}
+
+static void frame_cb(uev_t *w, void *arg, int events)
+{
+	uev_frame_t *f = (uev_frame_t *)arg;
+	uev_ctx_t *ctx = w->ctx;
+	uev_frame_view_t v;
+	size_t consume;
+	ssize_t nbytes;
+	int rc;
+
+	if (events & UEV_ERROR)
+		goto error;
+
+	if (f->tail - f->head < f->size) {
+		nbytes = frame_fill(f);
+		if (nbytes == 0) {
+			uev_frame_stop(f);
+			f->cb(f, f->arg, NULL, UEV_HUP);
+			return;
+		}
+		if (nbytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+			goto error;
+	}
+
+	while ((rc = frame_next(f, &v, &consume)) > 0) {
+		/*
+		 * Consume the frame before the callback, which may stop
+		 * the decoder and release its memory.  The view stays
+		 * valid, nothing is read into the ring meanwhile.
+		 */
+		f->head += consume;
+		f->cb(f, f->arg, &v, UEV_READ);
+
+		/* Stopped from the callback, do not touch @f */
+		if (ctx->current != w)
+			return;
+	}
+
+	if (rc < 0) {
+		errno = EMSGSIZE;
+		goto error;
+	}
+
+	/* Rewind an empty ring to keep reads contiguous */
+	if (f->head == f->tail)
+		f->head = f->tail = f->scan = 0;
+
+	return;
+
+error:
+	uev_frame_stop(f);
+	f->cb(f, f->arg, NULL, UEV_ERROR);
+}
+
+/**
+ * Create a framing decoder on a stream socket
+ * @param ctx    A valid libuEv context
+ * @param f      Pointer to an uev_frame_t decoder
+ * @param cb     Callback for each complete frame
+ * @param arg    Optional callback argument
+ * @param fd     Non-blocking stream socket to read from
+ * @param buf    Read ring storage, or NULL to allocate it from @param ctx
+ * @param size   Size of @param buf in bytes, must be a power of two
+ * @param mode   One of %UEV_FRAME_FIXED, %UEV_FRAME_LENPFX or %UEV_FRAME_DELIM
+ * @param param  Frame length, length prefix width or delimiter for @param mode
+ *
+ * Frames are handed to @param cb as views into @param buf and their
+ * space is reclaimed when the callback returns.  A frame can be at most
+ * @param size bytes, including its length prefix or delimiter.  A ring
+ * allocated here is released by uev_frame_stop().
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_frame_init(uev_ctx_t *ctx, uev_frame_t *f, uev_frame_cb_t *cb, void *arg, int fd,
+		   void *buf, size_t size, int mode, size_t param)
+{
+	if (!f || !cb || !size || (size & (size - 1))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	switch (mode) {
+	case UEV_FRAME_FIXED:
+		if (!param || param > size) {
+			errno = EINVAL;
+			return -1;
+		}
+		break;
+
+	case UEV_FRAME_LENPFX:
+		if (param != 1 && param != 2 && param != 4) {
+			errno = EINVAL;
+			return -1;
+		}
+		break;
+
+	case UEV_FRAME_DELIM:
+		if (param > 0xff) {
+			errno = EINVAL;
+			return -1;
+		}
+		break;
+
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+
+	f->allocated = 0;
+	if (!buf) {
+		buf = _uev_malloc(ctx, size);
+		if (!buf)
+			return -1;
+		f->allocated = 1;
+	}
+
+	f->buf   = buf;
+	f->size  = size;
+	f->head  = 0;
+	f->tail  = 0;
+	f->scan  = 0;
+	f->mode  = mode;
+	f->param = param;
+	f->cb    = cb;
+	f->arg   = arg;
+
+	if (uev_io_init(ctx, &f->w, frame_cb, f, fd, UEV_READ)) {
+		if (f->allocated)
+			_uev_free(ctx, f->buf, f->size);
+		f->allocated = 0;
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Stop a framing decoder
+ * @param f  Decoder to stop
+ *
+ * Any buffered partial frame is discarded.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_frame_stop(uev_frame_t *f)
+{
+	if (!f) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	f->head = f->tail = f->scan = 0;
+
+	if (f->allocated) {
+		_uev_free(f->w.ctx, f->buf, f->size);
+		f->allocated = 0;
+		f->buf = NULL;
+	}
+
+	return uev_io_stop(&f->w);
+}
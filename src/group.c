@@ -0,0 +1,243 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+
+#include <uev/uev.h>
+#include "list.h"
+
+/* Wakeup bits of the lists the members of @g live on */
+static EventBits_t group_bits(uev_group_t *g)
+{
+	struct uev_list_node *node;
+	EventBits_t bits = 0;
+
+	list_for_every(&g->members, node) {
+		uev_t *w = containerof(node, uev_t, gnode);
+
+		bits |= _uev_list_bit(_uev_list_index(w->type));
+	}
+
+	return bits;
+}
+
+/**
+ * Create a watcher group
+ * @param ctx  A valid libuEv context
+ * @param g    Pointer to an uev_group_t group
+ *
+ * A group lets all its members be suspended, resumed or stopped at
+ * once, e.g. all watchers of a client connection.  Each of these costs
+ * a single iothread wakeup and a single restart of the dispatch scan,
+ * regardless of the number of members.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_group_init(uev_ctx_t *ctx, uev_group_t *g)
+{
+	if (!ctx || !g) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	g->ctx = ctx;
+	list_initialize(&g->members);
+	atomic_init(&g->suspended, 0);
+
+	return 0;
+}
+
+/**
+ * Add a watcher to a group
+ * @param g  Group to add to
+ * @param w  Initialized watcher of the same context as @param g
+ *
+ * A watcher can be a member of one group at a time.  Initializing it
+ * again removes it from its group.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_group_add(uev_group_t *g, uev_t *w)
+{
+	if (!g || !w || w->ctx != g->ctx) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (w->group) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	list_add_tail(&g->members, &w->gnode);
+	w->group = g;
+	w->gself = w;
+
+	/* Joining a suspended group suspends the watcher */
+	if (atomic_load(&g->suspended) && w->type == UEV_IO_TYPE)
+		_uev_iothread_interrupt();
+
+	return 0;
+}
+
+/**
+ * Remove a watcher from its group
+ * @param w  Watcher to remove
+ *
+ * The watcher is left running, or is resumed if the group was suspended.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_group_del(uev_t *w)
+{
+	uev_group_t *g;
+
+	if (!w) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	g = w->group;
+	if (!g)
+		return 0;
+
+	list_delete(&w->gnode);
+	w->group = NULL;
+	w->gself = NULL;
+
+	if (atomic_load(&g->suspended)) {
+		if (w->type == UEV_IO_TYPE)
+			_uev_iothread_interrupt();
+		_uev_set_flags(g->ctx, _uev_list_bit(_uev_list_index(w->type)));
+	}
+
+	return 0;
+}
+
+/**
+ * Suspend all watchers in a group
+ * @param g  Group to suspend
+ *
+ * Members stay registered but their callbacks are not called and their
+ * descriptors are not polled.  Events posted and timers expiring in the
+ * meantime are delivered on uev_group_resume().
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_group_suspend(uev_group_t *g)
+{
+	if (!g) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (atomic_exchange(&g->suspended, 1))
+		return 0;
+
+	/* Let the iothread drop the descriptors from its set */
+	if (!list_is_empty(&g->members))
+		_uev_iothread_interrupt();
+
+	return 0;
+}
+
+/**
+ * Resume all watchers in a suspended group
+ * @param g  Group to resume
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_group_resume(uev_group_t *g)
+{
+	EventBits_t bits;
+
+	if (!g) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (!atomic_exchange(&g->suspended, 0))
+		return 0;
+
+	if (list_is_empty(&g->members))
+		return 0;
+
+	bits = group_bits(g);
+	if (bits & UEV_EG_BIT_IO)
+		_uev_iothread_interrupt();
+
+	/* Rescan the lists of anything that became ready while suspended */
+	g->ctx->watchers_changed = 1;
+	_uev_set_flags(g->ctx, bits);
+
+	return 0;
+}
+
+/**
+ * Stop all watchers in a group
+ * @param g  Group to stop
+ *
+ * All members are stopped and removed from the group, which is left
+ * empty and can be reused.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_group_stop(uev_group_t *g)
+{
+	struct uev_list_node *node, *tmp;
+	int wake = 0;
+
+	if (!g) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	list_for_every_safe(&g->members, node, tmp) {
+		uev_t *w = containerof(node, uev_t, gnode);
+
+		if (_uev_watcher_active(w)) {
+			if (w->type == UEV_IO_TYPE)
+				wake = 1;
+			if (w->type == UEV_EMBED_TYPE)
+				w->u.c.ctx->embed = NULL;
+
+			_uev_watcher_unlink(w);
+		}
+
+		/* Thread-safe timers stay listed while stopped */
+		if (w->type == UEV_TIMER_TS_TYPE)
+			_UEV_REMOVE(w, _UEV_LIST(w));
+
+		list_delete(&w->gnode);
+		w->group = NULL;
+		w->gself = NULL;
+	}
+
+	g->ctx->watchers_changed = 1;
+	atomic_store(&g->suspended, 0);
+
+	if (wake)
+		_uev_iothread_interrupt();
+
+	return 0;
+}
@@ -60,10 +60,63 @@ int uev_io_init(uev_ctx_t *ctx, uev_t *w, uev_cb_t *cb, void *arg, int fd, int e
  */
 int uev_io_set(uev_t *w, int fd, int events)
 {
+	if (!w) {
+		errno = EINVAL;
+		return -1;
+	}
+
 	/* Ignore any errors, only to clean up anything lingering ... */
 	uev_io_stop(w);
 
-	return uev_io_init(w->ctx, w, (uev_cb_t *)w->cb, w->arg, fd, events);
+	if (fd < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Not re-initialized, the watcher keeps its group membership */
+	w->fd     = fd;
+	w->events = events;
+	atomic_store(&w->iot.events, 0);
+
+	return _uev_watcher_start(w);
+}
+
+/**
+ * Change the events of an I/O watcher in place
+ * @param w       Pointer to an uev_t watcher
+ * @param events  Requested events to watch for, a mask of %UEV_READ and %UEV_WRITE
+ *
+ * Unlike uev_io_set() the watcher is not stopped and started again,
+ * so toggling %UEV_WRITE for flow control is cheap.  Events already
+ * ready but no longer requested are dropped.  The iothread is only
+ * woken up when it has to poll for something new.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_io_modify(uev_t *w, int events)
+{
+	unsigned int old, ready;
+
+	if (!w || w->type != UEV_IO_TYPE) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	w->events = events;
+	if (!_uev_watcher_active(w))
+		return 0;
+
+	old = atomic_exchange(&w->iot.mask, (unsigned int)events);
+	ready = atomic_fetch_and(&w->iot.events, (unsigned int)events | UEV_ERROR);
+
+	/*
+	 * A watcher with events ready is not polled, so dropping all
+	 * of them needs the iothread to take it back as well.
+	 */
+	if ((events & ~old) || (ready && !(ready & ((unsigned int)events | UEV_ERROR))))
+		_uev_iothread_interrupt();
+
+	return 0;
 }
 
 /**
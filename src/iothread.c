@@ -1,6 +1,6 @@
 #include <uev/uev.h>
-#include "list.h"
 
+#include <fcntl.h>
 #include <lwip/opt.h>
 #include <sys/select.h>
 #include <sys/socket.h>
@@ -11,7 +11,28 @@
 static TaskHandle_t task = NULL;
 static int fd_local = -1;
 static struct sockaddr_in sa_local;
-static struct uev_list_node list = LIST_INITIAL_VALUE(list);
+
+/*
+ * Watchers polled by the iothread.  The iothread walks the list without
+ * any lock, bumping seq to odd before and back to even after each walk.
+ * Writers serialize in the critical section, publish with atomic stores
+ * of the next pointers and wait out a walk in progress after removing.
+ */
+static atomic_uintptr_t head;
+static atomic_uint seq;
+
+/* Yields to wait out a walk before an unlink sleeps instead */
+#define UNLINK_SPINS 64
+
+#define for_each_watcher(w)							\
+	for (w = (uev_t *)atomic_load(&head); w; w = (uev_t *)atomic_load(&w->iot.next))
+
+#if CONFIG_UEV_STATS
+/* Time from select() returning until all watchers are flagged */
+static uint32_t stats_rounds;
+static uint32_t stats_round_last;
+static uint32_t stats_round_max;
+#endif
 
 static int locsock_create(struct sockaddr_in *sa){
 	int fd;
@@ -47,9 +68,39 @@ static int locsock_create(struct sockaddr_in *sa){
 	return fd;
 }
 
+/*
+ * Find the watchers whose descriptor was closed before they were
+ * stopped, which makes select() fail with EBADF for everyone.  They
+ * get UEV_ERROR and are left out of later rounds until started again.
+ * Returns the number of watchers isolated.
+ */
+static int isolate_bad_fds(void)
+{
+	int found = 0;
+	uev_t *w;
+
+	atomic_fetch_add(&seq, 1);
+	for_each_watcher(w) {
+		if (!_uev_watcher_active(w) || w->fd < 0 || w->iot.bad)
+			continue;
+		if (fcntl(w->fd, F_GETFL) >= 0 || errno != EBADF)
+			continue;
+
+		CROSSLOGE("bad descriptor %d, watcher isolated", w->fd);
+		w->iot.bad = 1;
+		atomic_fetch_or(&w->iot.events, UEV_ERROR);
+		_uev_set_flags(w->ctx, UEV_EG_BIT_IO);
+		found++;
+	}
+	atomic_fetch_add(&seq, 1);
+
+	return found;
+}
+
 void task_fn(void * ctx) {
 	int rc;
 	int maxfd;
+	unsigned int mask;
 	uev_t *w;
 	fd_set readfds;
 	fd_set writefds;
@@ -65,33 +116,41 @@ void task_fn(void * ctx) {
 		FD_SET(fd_local, &readfds);
 		maxfd = fd_local;
 
-		_uev_critical_enter();
-		list_for_every_entry(&list, w, uev_t, iot.node) {
+		atomic_fetch_add(&seq, 1);
+		for_each_watcher(w) {
 			if (!_uev_watcher_active(w))
 				continue;
-			if (w->fd < 0)
+			if (_uev_watcher_held(w))
+				continue;
+			if (w->fd < 0 || w->iot.bad)
 				continue;
 			if (atomic_load(&w->iot.events))
 				continue;
 
+			mask = atomic_load(&w->iot.mask);
 			if (w->fd > maxfd)
 				maxfd = w->fd;
 
-			if (w->events & UEV_READ)
+			if (mask & UEV_READ)
 				FD_SET(w->fd, &readfds);
 
-			if (w->events & UEV_WRITE)
+			if (mask & UEV_WRITE)
 				FD_SET(w->fd, &writefds);
 
-			if (w->events & UEV_ERROR)
+			if (mask & UEV_ERROR)
 				FD_SET(w->fd, &exceptfds);
 		}
-		_uev_critical_exit();
+		atomic_fetch_add(&seq, 1);
 
 		rc = select(maxfd + 1, &readfds, &writefds, &exceptfds, NULL);
+#if CONFIG_UEV_STATS
+		uint64_t round_start = _uev_timer_now();
+#endif
 		if (rc < 0) {
 			if (errno == EINTR)
 				continue;
+			if (errno == EBADF && isolate_bad_fds())
+				continue;
 
 			CROSSLOG_ERRNO("select");
 			vTaskDelay(1000 / portTICK_RATE_MS);
@@ -129,22 +188,23 @@ void task_fn(void * ctx) {
 			}
 		}
 
-		_uev_critical_enter();
-		list_for_every_entry(&list, w, uev_t, iot.node) {
+		atomic_fetch_add(&seq, 1);
+		for_each_watcher(w) {
 			unsigned int events = 0;
 
 			if (!_uev_watcher_active(w))
 				continue;
-			if (w->fd < 0)
+			if (w->fd < 0 || w->iot.bad)
 				continue;
 
-			if (FD_ISSET(w->fd, &readfds) && w->events & UEV_READ)
+			mask = atomic_load(&w->iot.mask);
+			if (FD_ISSET(w->fd, &readfds) && mask & UEV_READ)
 				events |= UEV_READ;
 
-			if (FD_ISSET(w->fd, &writefds) && w->events & UEV_WRITE)
+			if (FD_ISSET(w->fd, &writefds) && mask & UEV_WRITE)
 				events |= UEV_WRITE;
 
-			if (FD_ISSET(w->fd, &exceptfds) && w->events & UEV_ERROR)
+			if (FD_ISSET(w->fd, &exceptfds) && mask & UEV_ERROR)
 				events |= UEV_ERROR;
 
 			if (events) {
@@ -152,7 +212,14 @@ void task_fn(void * ctx) {
 				_uev_set_flags(w->ctx, UEV_EG_BIT_IO);
 			}
 		}
-		_uev_critical_exit();
+		atomic_fetch_add(&seq, 1);
+
+#if CONFIG_UEV_STATS
+		stats_round_last = _uev_timer_now() - round_start;
+		if (stats_round_last > stats_round_max)
+			stats_round_max = stats_round_last;
+		stats_rounds++;
+#endif
 	}
 
 task_end:
@@ -190,20 +257,64 @@ int uev_iothread_init(void) {
 
 void _uev_iothread_watcher_add(uev_t *w) {
 	_uev_critical_enter();
-	list_add_tail(&list, &w->iot.node);
+	uev_t *first = (uev_t *)atomic_load(&head);
+
+	w->iot.prev = NULL;
+	w->iot.bad = 0;
+	atomic_store(&w->iot.mask, w->events);
+	atomic_store(&w->iot.next, (uintptr_t)first);
+	if (first)
+		first->iot.prev = w;
+	atomic_store(&head, (uintptr_t)w);
 	_uev_critical_exit();
 
 	_uev_iothread_interrupt();
 }
 
-void _uev_iothread_watcher_remove(uev_t *w) {
+/*
+ * The next pointer of @w is left intact for a walk already past it.
+ * Returns once no walk can reach @w anymore, so it may be reused.
+ */
+void _uev_iothread_watcher_unlink(uev_t *w) {
+	unsigned int s, spins;
+
 	_uev_critical_enter();
-	list_delete(&w->iot.node);
+	uev_t *next = (uev_t *)atomic_load(&w->iot.next);
+
+	if (w->iot.prev)
+		atomic_store(&w->iot.prev->iot.next, (uintptr_t)next);
+	else
+		atomic_store(&head, (uintptr_t)next);
+	if (next)
+		next->iot.prev = w->iot.prev;
+	w->iot.prev = NULL;
 	_uev_critical_exit();
 
-	_uev_iothread_interrupt();
+	/*
+	 * Grace period, let the iothread finish its walk.  That is only a
+	 * few instructions, so yield rather than sleep for a tick.  Only
+	 * if the iothread was preempted by us, and a yield cannot run it,
+	 * do we fall back to sleeping.
+	 */
+	s = atomic_load(&seq);
+	if (s & 1) {
+		for (spins = 0; atomic_load(&seq) == s; spins++) {
+			if (spins < UNLINK_SPINS)
+				taskYIELD();
+			else
+				vTaskDelay(1);
+		}
+	}
 }
 
+#if CONFIG_UEV_STATS
+void _uev_iothread_stats(uint32_t *rounds, uint32_t *round_last, uint32_t *round_max) {
+	*rounds = stats_rounds;
+	*round_last = stats_round_last;
+	*round_max = stats_round_max;
+}
+#endif
+
 void _uev_iothread_interrupt(void) {
 	ssize_t nbytes;
 	uint8_t b = 0x01;
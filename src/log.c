@@ -0,0 +1,240 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <uev/log.h>
+#include "mpq.h"
+
+/* Max. number of records formatted per drain */
+#define LOG_BATCH  16
+
+struct log_rec {
+	const char     *fmt;
+	uint32_t        ms;		/* Wraps after 49.7 days of uptime */
+	int             args[UEV_LOG_ARGS];
+};
+
+/* Append one line to the output buffer, flushing it first if full */
+static size_t log_format(uev_log_t *l, size_t len, const char *fmt, uint32_t ms, const int *a)
+{
+	int n, m;
+
+	for (;;) {
+		size_t room = sizeof(l->buf) - len;
+
+		/* Encoding error, drop the record and keep what we have */
+		n = snprintf(l->buf + len, room, "%u ", (unsigned int)ms);
+		if (n < 0)
+			return len;
+		if ((size_t)n < room) {
+			m = snprintf(l->buf + len + n, room - n, fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+			if (m < 0)
+				return len;
+			n += m;
+		}
+		if ((size_t)n + 1 < room) {
+			len += n;
+			l->buf[len++] = '\n';
+			return len;
+		}
+
+		/* Lines too long for an empty buffer are cut */
+		if (!len) {
+			l->buf[sizeof(l->buf) - 1] = '\n';
+			l->out(l->arg, l->buf, sizeof(l->buf));
+			return 0;
+		}
+
+		l->out(l->arg, l->buf, len);
+		len = 0;
+	}
+}
+
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Called by uev_run() before it blocks.  Formats and writes one batch
+ * of records, returns 1 if more are queued and the loop should poll
+ * rather than block.
+ */
+int _uev_log_drain(uev_ctx_t *ctx)
+{
+	uev_log_t *l = ctx->log;
+	struct log_rec r;
+	unsigned int dropped;
+	size_t len = 0;
+	int n = 0;
+
+	while (n < LOG_BATCH && _uev_mpq_pop(l->q, &r)) {
+		len = log_format(l, len, r.fmt, r.ms, r.args);
+		n++;
+	}
+
+	dropped = atomic_load(&l->dropped);
+	if (dropped != l->reported) {
+		int a[UEV_LOG_ARGS] = { (int)(dropped - l->reported) };
+
+		len = log_format(l, len, "uev_log: %d records dropped",
+				 (uint32_t)(_uev_timer_now() / 1000), a);
+		l->reported = dropped;
+	}
+
+	if (len)
+		l->out(l->arg, l->buf, len);
+
+	if (n == LOG_BATCH)
+		return 1;
+
+	/* Pairs with uev_log_put(), a record pushed meanwhile is not missed */
+	atomic_store(&l->armed, 0);
+	if (_uev_mpq_pop(l->q, &r)) {
+		atomic_store(&l->armed, 1);
+		len = log_format(l, 0, r.fmt, r.ms, r.args);
+		l->out(l->arg, l->buf, len);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Create a log sink
+ * @param ctx       A valid libuEv context to write the records from
+ * @param l         Pointer to an uev_log_t sink
+ * @param out       Output function, e.g. writing to a UART or a file
+ * @param arg       Optional argument to @param out
+ * @param capacity  Max. number of records queued, a power of two
+ *
+ * The ring is allocated from @param ctx.  Each context has at most
+ * one sink.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_log_init(uev_ctx_t *ctx, uev_log_t *l, uev_log_out_t *out, void *arg, size_t capacity)
+{
+	if (!ctx || !l || !out) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (ctx->log) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	l->q = _uev_mpq_new(ctx, capacity, sizeof(struct log_rec));
+	if (!l->q)
+		return -1;
+
+	l->ctx      = ctx;
+	l->out      = out;
+	l->arg      = arg;
+	l->reported = 0;
+	atomic_init(&l->armed, 0);
+	atomic_init(&l->dropped, 0);
+
+	ctx->log = l;
+
+	return 0;
+}
+
+/**
+ * Stop a log sink
+ * @param l  Sink to stop
+ *
+ * Writes out any queued records before the ring is released.  No task
+ * may log to @param l any more.  Must be called from the task running
+ * the context of @param l, e.g. from one of its callbacks, or while
+ * that context is not running, since the loop drains the ring.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %EPERM if called from another task while the loop is running.
+ */
+int uev_log_stop(uev_log_t *l)
+{
+	if (!l || !l->q) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (atomic_load(&l->ctx->running) && l->ctx->owner != xTaskGetCurrentTaskHandle()) {
+		errno = EPERM;
+		return -1;
+	}
+
+	while (_uev_log_drain(l->ctx))
+		;
+
+	l->ctx->log = NULL;
+	_uev_mpq_free(l->ctx, l->q);
+	l->q = NULL;
+
+	return 0;
+}
+
+/**
+ * Queue a log record
+ * @param l      A valid log sink
+ * @param fmt    printf() format string, must outlive the record
+ * @param nargs  Number of int arguments following, at most %UEV_LOG_ARGS
+ *
+ * Use the uev_log() macro, which counts the arguments.  Safe to call
+ * from any task or ISR, it never blocks.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %ENOBUFS when the record was dropped.
+ */
+int uev_log_put(uev_log_t *l, const char *fmt, int nargs, ...)
+{
+	struct log_rec r = { 0 };
+	va_list ap;
+	int i;
+
+	if (!l || !l->q || !fmt || nargs < 0 || nargs > UEV_LOG_ARGS) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	r.fmt = fmt;
+	r.ms  = (uint32_t)(_uev_timer_now() / 1000);
+
+	va_start(ap, nargs);
+	for (i = 0; i < nargs; i++)
+		r.args[i] = va_arg(ap, int);
+	va_end(ap);
+
+	if (_uev_mpq_push(l->q, &r)) {
+		atomic_fetch_add(&l->dropped, 1);
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	/* Only the first record after a drain wakes up the loop */
+	if (!atomic_exchange(&l->armed, 1))
+		_uev_set_flags(l->ctx, UEV_EG_BIT_LOG);
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include <uev/uev.h>
+
+/* Private to libuEv, do not use directly! */
+int _uev_mem_charge(uev_ctx_t *ctx, size_t size)
+{
+	size_t used = atomic_load(&ctx->mem.used);
+	size_t peak;
+
+	do {
+		if (ctx->mem.limit && (size > ctx->mem.limit || used > ctx->mem.limit - size)) {
+			errno = ENOMEM;
+			return -1;
+		}
+	} while (!atomic_compare_exchange_weak(&ctx->mem.used, &used, used + size));
+
+	used += size;
+	peak = atomic_load(&ctx->mem.peak);
+	while (used > peak && !atomic_compare_exchange_weak(&ctx->mem.peak, &peak, used))
+		;
+
+	return 0;
+}
+
+/* Private to libuEv, do not use directly! */
+void _uev_mem_uncharge(uev_ctx_t *ctx, size_t size)
+{
+	atomic_fetch_sub(&ctx->mem.used, size);
+}
+
+/* Private to libuEv, do not use directly! */
+void *_uev_malloc(uev_ctx_t *ctx, size_t size)
+{
+	void *ptr;
+
+	if (!ctx) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (_uev_mem_charge(ctx, size))
+		return NULL;
+
+	ptr = malloc(size);
+	if (!ptr) {
+		_uev_mem_uncharge(ctx, size);
+		errno = ENOMEM;
+	}
+
+	return ptr;
+}
+
+/* Private to libuEv, do not use directly! */
+void _uev_free(uev_ctx_t *ctx, void *ptr, size_t size)
+{
+	if (!ptr)
+		return;
+
+	free(ptr);
+	_uev_mem_uncharge(ctx, size);
+}
+
+/**
+ * Cap the memory allocated on behalf of a context
+ * @param ctx    A valid libuEv context
+ * @param limit  Max. number of bytes, or zero for no limit
+ *
+ * Every allocation libuEv makes for a context, such as rings and
+ * queues, is charged to it.  Allocations which would exceed the limit
+ * fail with %ENOMEM without touching the heap.  Lowering the limit
+ * below the current usage only affects later allocations.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_mem_limit(uev_ctx_t *ctx, size_t limit)
+{
+	if (!ctx) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx->mem.limit = limit;
+
+	return 0;
+}
+
+/**
+ * Get the memory allocated on behalf of a context
+ * @param ctx   A valid libuEv context
+ * @param used  Current usage in bytes, or NULL
+ * @param peak  Highest usage in bytes since uev_init(), or NULL
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_mem_usage(uev_ctx_t *ctx, size_t *used, size_t *peak)
+{
+	if (!ctx) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (used)
+		*used = atomic_load(&ctx->mem.used);
+	if (peak)
+		*peak = atomic_load(&ctx->mem.peak);
+
+	return 0;
+}
@@ -0,0 +1,144 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "mpq.h"
+
+/* Cells start with their sequence number, followed by the record */
+#define CELL_ALIGN  sizeof(uint64_t)
+
+static inline atomic_size_t *cell_seq(struct uev_mpq *q, size_t pos)
+{
+	return (atomic_size_t *)(q->cells + (pos & q->mask) * q->stride);
+}
+
+static inline void *cell_rec(struct uev_mpq *q, size_t pos)
+{
+	return q->cells + (pos & q->mask) * q->stride + CELL_ALIGN;
+}
+
+static size_t mpq_stride(size_t size)
+{
+	return CELL_ALIGN + ((size + CELL_ALIGN - 1) & ~(CELL_ALIGN - 1));
+}
+
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Allocate a queue of @capacity records of @size bytes from @ctx,
+ * @capacity must be a power of two.
+ */
+struct uev_mpq *_uev_mpq_new(uev_ctx_t *ctx, size_t capacity, size_t size)
+{
+	struct uev_mpq *q;
+	size_t stride, i;
+
+	if (!capacity || (capacity & (capacity - 1)) || !size) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	stride = mpq_stride(size);
+	q = _uev_malloc(ctx, sizeof(*q) + capacity * stride);
+	if (!q)
+		return NULL;
+
+	q->mask   = capacity - 1;
+	q->size   = size;
+	q->stride = stride;
+	atomic_init(&q->head, 0);
+	atomic_init(&q->tail, 0);
+	for (i = 0; i < capacity; i++)
+		atomic_init(cell_seq(q, i), i);
+
+	return q;
+}
+
+/* Private to libuEv, do not use directly! */
+void _uev_mpq_free(uev_ctx_t *ctx, struct uev_mpq *q)
+{
+	if (!q)
+		return;
+
+	_uev_free(ctx, q, sizeof(*q) + (q->mask + 1) * q->stride);
+}
+
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Returns 0, or -1 if the queue is full.
+ */
+int _uev_mpq_push(struct uev_mpq *q, const void *rec)
+{
+	size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+	size_t seq;
+
+	for (;;) {
+		seq = atomic_load_explicit(cell_seq(q, pos), memory_order_acquire);
+		if (seq == pos) {
+			if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1,
+								  memory_order_relaxed, memory_order_relaxed))
+				break;
+		} else if ((ptrdiff_t)(seq - pos) < 0) {
+			return -1;
+		} else {
+			pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+		}
+	}
+
+	memcpy(cell_rec(q, pos), rec, q->size);
+	atomic_store_explicit(cell_seq(q, pos), pos + 1, memory_order_release);
+
+	return 0;
+}
+
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Returns 1 with the oldest record copied to @rec, or 0 if empty.
+ */
+int _uev_mpq_pop(struct uev_mpq *q, void *rec)
+{
+	size_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+	size_t seq;
+
+	for (;;) {
+		seq = atomic_load_explicit(cell_seq(q, pos), memory_order_acquire);
+		if (seq == pos + 1) {
+			if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1,
+								  memory_order_relaxed, memory_order_relaxed))
+				break;
+		} else if ((ptrdiff_t)(seq - (pos + 1)) < 0) {
+			return 0;
+		} else {
+			pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+		}
+	}
+
+	memcpy(rec, cell_rec(q, pos), q->size);
+	atomic_store_explicit(cell_seq(q, pos), pos + q->mask + 1, memory_order_release);
+
+	return 1;
+}
@@ -0,0 +1,47 @@
+/* libuEv - Bounded lock-free MPMC queue of fixed size records, internal
+ *
+ * Dmitry Vyukov's bounded queue.  Each cell carries a sequence number
+ * telling producers and consumers whose turn it is, so any number of
+ * tasks and ISRs may push and pop concurrently without a lock.
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIBUEV_MPQ_H
+#define LIBUEV_MPQ_H
+
+#include <uev/uev.h>
+
+struct uev_mpq {
+	size_t          mask;
+	size_t          size;	/* Record size */
+	size_t          stride;	/* Cell size */
+	atomic_size_t   head;	/* Next cell to pop */
+	atomic_size_t   tail;	/* Next cell to push */
+	unsigned char   cells[];
+};
+
+struct uev_mpq *_uev_mpq_new (uev_ctx_t *ctx, size_t capacity, size_t size);
+void            _uev_mpq_free(uev_ctx_t *ctx, struct uev_mpq *q);
+int             _uev_mpq_push(struct uev_mpq *q, const void *rec);
+int             _uev_mpq_pop (struct uev_mpq *q, void *rec);
+
+#endif /* LIBUEV_MPQ_H */
@@ -0,0 +1,166 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <uev/prof.h>
+
+#if CONFIG_UEV_PROFILER
+
+#include <errno.h>
+
+/* Runs in the esp_timer task, possibly on another core than the loop */
+static void prof_sample(void *arg)
+{
+	uev_prof_t *p = (uev_prof_t *)arg;
+	uintptr_t cb = atomic_load(&p->ctx->prof_cb);
+	size_t i, n;
+
+	if (!cb) {
+		atomic_fetch_add(&p->idle, 1);
+		return;
+	}
+
+	/* Lock-free insert, a slot's key never changes once claimed */
+	i = (cb >> 2) & (UEV_PROF_SLOTS - 1);
+	for (n = 0; n < UEV_PROF_SLOTS; n++, i = (i + 1) & (UEV_PROF_SLOTS - 1)) {
+		uintptr_t key = atomic_load(&p->key[i]);
+
+		if (!key && atomic_compare_exchange_strong(&p->key[i], &key, cb))
+			key = cb;
+
+		if (key == cb) {
+			atomic_fetch_add(&p->count[i], 1);
+			return;
+		}
+	}
+
+	atomic_fetch_add(&p->lost, 1);
+}
+
+/**
+ * Start sampling a context
+ * @param ctx        A valid libuEv context
+ * @param p          Pointer to a zeroed or stopped uev_prof_t profiler
+ * @param period_us  Sampling period in microseconds
+ *
+ * Any previous samples in @param p are cleared.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %EBUSY if @param p is already running.
+ */
+int uev_prof_start(uev_ctx_t *ctx, uev_prof_t *p, unsigned int period_us)
+{
+	esp_timer_create_args_t args = {
+		.callback = prof_sample,
+		.arg      = p,
+		.name     = "uev_prof",
+	};
+	size_t i;
+
+	if (!ctx || !p || !period_us) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* A second timer would leak the first, still sampling into @p */
+	if (p->timer) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	p->ctx = ctx;
+	for (i = 0; i < UEV_PROF_SLOTS; i++) {
+		atomic_init(&p->key[i], 0);
+		atomic_init(&p->count[i], 0);
+	}
+	atomic_init(&p->idle, 0);
+	atomic_init(&p->lost, 0);
+
+	if (esp_timer_create(&args, &p->timer) != ESP_OK) {
+		p->timer = NULL;
+		errno = ENOMEM;
+		return -1;
+	}
+
+	if (esp_timer_start_periodic(p->timer, period_us) != ESP_OK) {
+		esp_timer_delete(p->timer);
+		p->timer = NULL;
+		errno = EINVAL;
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Stop sampling
+ * @param p  Profiler to stop
+ *
+ * The samples are kept and can still be dumped.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_prof_stop(uev_prof_t *p)
+{
+	if (!p || !p->timer) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	esp_timer_stop(p->timer);
+	esp_timer_delete(p->timer);
+	p->timer = NULL;
+
+	return 0;
+}
+
+/**
+ * Write the samples as folded stacks
+ * @param p   Profiler to dump, running or stopped
+ * @param fp  Stream to write to
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_prof_dump(uev_prof_t *p, FILE *fp)
+{
+	size_t i;
+
+	if (!p || !fp) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < UEV_PROF_SLOTS; i++) {
+		uintptr_t key = atomic_load(&p->key[i]);
+
+		if (key)
+			fprintf(fp, "uev_run;0x%08lx %u\n", (unsigned long)key, atomic_load(&p->count[i]));
+	}
+
+	fprintf(fp, "uev_idle %u\n", atomic_load(&p->idle));
+	if (atomic_load(&p->lost))
+		fprintf(fp, "uev_lost %u\n", atomic_load(&p->lost));
+
+	return 0;
+}
+
+#endif /* CONFIG_UEV_PROFILER */
@@ -0,0 +1,264 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+
+#include <uev/sampler.h>
+
+static inline void *sample_at(uev_sampler_t *s, size_t pos)
+{
+	return s->data + (pos & s->mask) * s->size;
+}
+
+static void sampler_take(uev_sampler_t *s)
+{
+	uint64_t now = _uev_timer_now();
+	size_t tail = atomic_load_explicit(&s->tail, memory_order_relaxed);
+	size_t head = atomic_load_explicit(&s->head, memory_order_acquire);
+
+	if (tail - head > s->mask) {
+		atomic_fetch_add(&s->dropped, 1);
+		return;
+	}
+
+	if (s->read(s, s->arg, sample_at(s, tail)))
+		return;
+
+	s->ts[tail & s->mask] = now;
+	atomic_store_explicit(&s->tail, tail + 1, memory_order_release);
+
+	if (tail == s->mark)
+		s->mark_ts = now;
+
+	if (tail + 1 - s->mark >= s->batch ||
+	    (s->latency_us && now - s->mark_ts >= s->latency_us)) {
+		s->mark = tail + 1;
+		uev_event_post(&s->w);
+	}
+}
+
+/* Runs in the esp_timer task, or its ISR if asked for, never in the event loop */
+static void sampler_tick(void *arg)
+{
+	uev_sampler_t *s = (uev_sampler_t *)arg;
+
+	/*
+	 * Stopping the timer does not wait for a tick already running on
+	 * the other core, so uev_sampler_stop() waits for us to leave
+	 * before it releases the ring.  Pairs with the order there.
+	 */
+	atomic_fetch_add(&s->ticking, 1);
+	if (!atomic_load(&s->stopping))
+		sampler_take(s);
+	atomic_fetch_sub(&s->ticking, 1);
+}
+
+static void sampler_cb(uev_t *w, void *arg, int events)
+{
+	uev_sampler_t *s = (uev_sampler_t *)arg;
+	uev_ctx_t *ctx = w->ctx;
+	size_t head, tail, off, n;
+
+	if (events & UEV_ERROR)
+		return;
+
+	head = atomic_load_explicit(&s->head, memory_order_relaxed);
+	tail = atomic_load_explicit(&s->tail, memory_order_acquire);
+
+	/* At most two spans, before and after the end of the ring */
+	while (head != tail) {
+		off = head & s->mask;
+		n = tail - head;
+		if (n > s->mask + 1 - off)
+			n = s->mask + 1 - off;
+
+		s->cb(s, s->arg, &s->ts[off], sample_at(s, head), n);
+
+		/* Stopped from the callback, do not touch @s */
+		if (ctx->current != w)
+			return;
+
+		head += n;
+		atomic_store_explicit(&s->head, head, memory_order_release);
+	}
+}
+
+static void sampler_free(uev_sampler_t *s)
+{
+	uev_ctx_t *ctx = s->w.ctx;
+	size_t capacity = s->mask + 1;
+
+	_uev_free(ctx, s->ts, capacity * sizeof(s->ts[0]));
+	_uev_free(ctx, s->data, capacity * s->size);
+	s->ts = NULL;
+	s->data = NULL;
+}
+
+/**
+ * Create and start a sampler
+ * @param ctx        A valid libuEv context to run @param cb in
+ * @param s          Pointer to an uev_sampler_t sampler
+ * @param cb         Callback with a batch of samples
+ * @param arg        Optional argument to @param cb and @param read
+ * @param read       Function reading one sample, called every @param period_us
+ * @param size       Size of a sample in bytes
+ * @param capacity   Max. number of samples buffered, a power of two
+ * @param period_us  Sampling period in microseconds
+ * @param flags      Zero, or %UEV_SAMPLER_ISR
+ *
+ * The ring is allocated from @param ctx.  @param read runs in the
+ * esp_timer task, so it must not block for long and must not touch
+ * state owned by the event loop.  With %UEV_SAMPLER_ISR it runs in the
+ * timer ISR instead, for less jitter, and must not block at all, which
+ * rules out most I2C and SPI drivers.  This requires
+ * CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD.  By default the
+ * consumer is woken when half the ring is filled, see
+ * uev_sampler_batch().  Samples arriving while the ring is full are
+ * counted in the dropped counter.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %ENOTSUP if %UEV_SAMPLER_ISR is not supported.
+ */
+int uev_sampler_init(uev_ctx_t *ctx, uev_sampler_t *s, uev_sampler_cb_t *cb, void *arg,
+		     uev_sample_fn_t *read, size_t size, size_t capacity, unsigned int period_us,
+		     int flags)
+{
+	esp_timer_create_args_t args = {
+		.callback = sampler_tick,
+		.arg      = s,
+		.dispatch_method = ESP_TIMER_TASK,
+		.name     = "uev_sampler",
+	};
+
+	if (!ctx || !s || !cb || !read || !size || !period_us ||
+	    capacity < 2 || (capacity & (capacity - 1)) || (flags & ~UEV_SAMPLER_ISR)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (flags & UEV_SAMPLER_ISR) {
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+		args.dispatch_method = ESP_TIMER_ISR;
+#else
+		errno = ENOTSUP;
+		return -1;
+#endif
+	}
+
+	s->read   = read;
+	s->cb     = cb;
+	s->arg    = arg;
+	s->size   = size;
+	s->mask   = capacity - 1;
+	s->batch  = capacity / 2;
+	s->latency_us = 0;
+	s->mark   = 0;
+	s->mark_ts = 0;
+	atomic_init(&s->head, 0);
+	atomic_init(&s->tail, 0);
+	atomic_init(&s->dropped, 0);
+	atomic_init(&s->stopping, 0);
+	atomic_init(&s->ticking, 0);
+
+	if (uev_event_init(ctx, &s->w, sampler_cb, s))
+		return -1;
+
+	s->ts   = _uev_malloc(ctx, capacity * sizeof(s->ts[0]));
+	s->data = _uev_malloc(ctx, capacity * size);
+	if (!s->ts || !s->data)
+		goto fail;
+
+	if (esp_timer_create(&args, &s->timer) != ESP_OK) {
+		errno = ENOMEM;
+		goto fail;
+	}
+
+	if (esp_timer_start_periodic(s->timer, period_us) != ESP_OK) {
+		esp_timer_delete(s->timer);
+		errno = EINVAL;
+		goto fail;
+	}
+
+	return 0;
+fail:
+	s->timer = NULL;
+	sampler_free(s);
+	uev_event_stop(&s->w);
+	return -1;
+}
+
+/**
+ * Set when the consumer of a sampler is woken up
+ * @param s           A valid sampler
+ * @param batch       Number of samples per wakeup, at most the capacity
+ * @param latency_us  Max. time a sample waits for a wakeup, or zero for no limit
+ *
+ * The consumer is woken when either @param batch samples are ready or
+ * the oldest of them was captured @param latency_us ago, which is
+ * checked at each new sample.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_sampler_batch(uev_sampler_t *s, size_t batch, unsigned int latency_us)
+{
+	if (!s || !batch || batch > s->mask + 1) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	s->batch = batch;
+	s->latency_us = latency_us;
+
+	return 0;
+}
+
+/**
+ * Stop a sampler
+ * @param s  Sampler to stop
+ *
+ * Samples not yet consumed are discarded and the ring is released,
+ * once a sample being read on another core is done.  Must not be
+ * called from an ISR.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_sampler_stop(uev_sampler_t *s)
+{
+	if (!s || !s->timer) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Ticks from now on leave the ring alone, wait out the others */
+	atomic_store(&s->stopping, 1);
+	esp_timer_stop(s->timer);
+	while (atomic_load(&s->ticking))
+		vTaskDelay(1);
+
+	esp_timer_delete(s->timer);
+	s->timer = NULL;
+
+	sampler_free(s);
+
+	return uev_event_stop(&s->w);
+}
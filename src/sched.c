@@ -0,0 +1,344 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+
+#include <uev/sched.h>
+
+/*
+ * Chase-Lev work-stealing deque of fixed capacity.  The owner pushes
+ * and pops at the bottom, thieves steal from the top.
+ */
+struct uev_sched_q {
+	uev_sched_t          *sched;
+	uev_ctx_t            *ctx;
+	int                   index;
+
+	/* Set while the owner is blocked, cleared by whoever wakes it */
+	atomic_int            idle;
+
+	atomic_long           top;
+	atomic_long           bottom;
+	long                  mask;
+	atomic_uintptr_t      tasks[];
+};
+
+static int q_push(struct uev_sched_q *q, uev_task_t *t)
+{
+	long b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+	long top = atomic_load_explicit(&q->top, memory_order_acquire);
+
+	if (b - top > q->mask)
+		return -1;
+
+	atomic_store_explicit(&q->tasks[b & q->mask], (uintptr_t)t, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+
+	return 0;
+}
+
+static uev_task_t *q_pop(struct uev_sched_q *q)
+{
+	long b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+	long top;
+	uev_task_t *t;
+
+	atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	top = atomic_load_explicit(&q->top, memory_order_relaxed);
+
+	if (top > b) {
+		atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+		return NULL;
+	}
+
+	t = (uev_task_t *)atomic_load_explicit(&q->tasks[b & q->mask], memory_order_relaxed);
+	if (top == b) {
+		/* Last task, race the thieves for it */
+		if (!atomic_compare_exchange_strong_explicit(&q->top, &top, top + 1,
+							     memory_order_seq_cst, memory_order_relaxed))
+			t = NULL;
+		atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+	}
+
+	return t;
+}
+
+static uev_task_t *q_steal(struct uev_sched_q *q)
+{
+	long top = atomic_load_explicit(&q->top, memory_order_acquire);
+	long b;
+	uev_task_t *t;
+
+	atomic_thread_fence(memory_order_seq_cst);
+	b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+	if (top >= b)
+		return NULL;
+
+	t = (uev_task_t *)atomic_load_explicit(&q->tasks[top & q->mask], memory_order_relaxed);
+	if (!atomic_compare_exchange_strong_explicit(&q->top, &top, top + 1,
+						     memory_order_seq_cst, memory_order_relaxed))
+		return NULL;
+
+	return t;
+}
+
+/* Take a task from our own deque, or else from the siblings in turn */
+static uev_task_t *sched_take(struct uev_sched_q *q)
+{
+	uev_sched_t *s = q->sched;
+	int n = atomic_load(&s->count);
+	uev_task_t *t;
+	int i;
+
+	t = q_pop(q);
+	for (i = 1; !t && i < n; i++)
+		t = q_steal(s->q[(q->index + i) % n]);
+
+	return t;
+}
+
+static void sched_call(uev_ctx_t *ctx, uev_task_t *t)
+{
+#if CONFIG_UEV_PROFILER
+	atomic_store(&ctx->prof_cb, (uintptr_t)t->cb);
+#endif
+	t->cb(t, t->arg);
+#if CONFIG_UEV_PROFILER
+	atomic_store(&ctx->prof_cb, 0);
+#endif
+}
+
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Called by uev_run() before it blocks.  Runs one task and returns 1,
+ * in which case the loop should poll rather than block, or marks the
+ * context idle and returns 0.
+ */
+int _uev_sched_run(uev_ctx_t *ctx)
+{
+	struct uev_sched_q *q = ctx->sched;
+	uev_task_t *t;
+
+	t = sched_take(q);
+	if (!t) {
+		/* Pairs with the idle check in uev_sched_spawn() */
+		atomic_store(&q->idle, 1);
+		t = sched_take(q);
+		if (!t)
+			return 0;
+		atomic_store(&q->idle, 0);
+	}
+
+	sched_call(ctx, t);
+
+	return 1;
+}
+
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Called by uev_run() after every event scan, so a context which never
+ * gets to block still runs its own tasks.  Runs at most %UEV_SCHED_SLICE
+ * of them, without stealing, and returns the number run.
+ */
+int _uev_sched_slice(uev_ctx_t *ctx)
+{
+	struct uev_sched_q *q = ctx->sched;
+	uev_task_t *t;
+	int n;
+
+	for (n = 0; n < UEV_SCHED_SLICE && (t = q_pop(q)); n++)
+		sched_call(ctx, t);
+
+	return n;
+}
+
+/* Private to libuEv, do not use directly! */
+void _uev_sched_awake(uev_ctx_t *ctx)
+{
+	atomic_store(&ctx->sched->idle, 0);
+}
+
+/**
+ * Create a scheduler
+ * @param s  Pointer to an uev_sched_t scheduler
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_sched_init(uev_sched_t *s)
+{
+	int i;
+
+	if (!s) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < UEV_SCHED_MAX; i++)
+		s->q[i] = NULL;
+	atomic_init(&s->count, 0);
+
+	return 0;
+}
+
+/**
+ * Attach a context to a scheduler
+ * @param s         A valid scheduler
+ * @param ctx       A valid libuEv context, not attached to any scheduler
+ * @param capacity  Max. number of tasks queued on @param ctx, a power of two
+ *
+ * The deque is allocated from @param ctx.  Contexts are attached from
+ * one task, before or while the others are running.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_sched_attach(uev_sched_t *s, uev_ctx_t *ctx, size_t capacity)
+{
+	struct uev_sched_q *q;
+	int n;
+
+	if (!s || !ctx || !capacity || (capacity & (capacity - 1))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (ctx->sched) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	n = atomic_load(&s->count);
+	if (n >= UEV_SCHED_MAX) {
+		errno = ENOSPC;
+		return -1;
+	}
+
+	q = _uev_malloc(ctx, sizeof(*q) + capacity * sizeof(q->tasks[0]));
+	if (!q)
+		return -1;
+
+	q->sched = s;
+	q->ctx   = ctx;
+	q->index = n;
+	q->mask  = (long)capacity - 1;
+	atomic_init(&q->idle, 0);
+	atomic_init(&q->top, 0);
+	atomic_init(&q->bottom, 0);
+
+	ctx->sched = q;
+	s->q[n] = q;
+	atomic_store(&s->count, n + 1);
+
+	return 0;
+}
+
+/**
+ * Detach a context from its scheduler
+ * @param ctx  A context attached to a scheduler
+ *
+ * No context of the scheduler may be running.  Tasks still queued on
+ * @param ctx are dropped without being called.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_sched_detach(uev_ctx_t *ctx)
+{
+	struct uev_sched_q *q;
+	uev_sched_t *s;
+	int n;
+
+	if (!ctx || !ctx->sched) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	q = ctx->sched;
+	s = q->sched;
+	n = atomic_load(&s->count) - 1;
+
+	/* Move the last deque into the hole */
+	s->q[q->index] = s->q[n];
+	s->q[q->index]->index = q->index;
+	s->q[n] = NULL;
+	atomic_store(&s->count, n);
+
+	ctx->sched = NULL;
+	_uev_free(ctx, q, sizeof(*q) + ((size_t)q->mask + 1) * sizeof(q->tasks[0]));
+
+	return 0;
+}
+
+/**
+ * Spawn a deferred task
+ * @param ctx  Context the task is queued on, must be attached to a scheduler
+ * @param t    Pointer to an uev_task_t, owned by libuEv until @param cb is called
+ * @param cb   Task function
+ * @param arg  Optional argument to @param cb
+ *
+ * Must be called from the task running @param ctx, e.g. from one of
+ * its callbacks.  The task is run by @param ctx after an event scan,
+ * at most %UEV_SCHED_SLICE per scan, or by a sibling context with
+ * nothing else to do, which is woken up if it is blocked.  It may free
+ * @param t.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %ENOBUFS when the deque of @param ctx is full.
+ */
+int uev_sched_spawn(uev_ctx_t *ctx, uev_task_t *t, uev_task_cb_t *cb, void *arg)
+{
+	struct uev_sched_q *q;
+	uev_sched_t *s;
+	int i, n;
+
+	if (!ctx || !ctx->sched || !t || !cb) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	t->cb  = cb;
+	t->arg = arg;
+
+	q = ctx->sched;
+	if (q_push(q, t)) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	/* Wake up one idle sibling to steal it, pairs with _uev_sched_run() */
+	atomic_thread_fence(memory_order_seq_cst);
+	s = q->sched;
+	n = atomic_load(&s->count);
+	for (i = 1; i < n; i++) {
+		struct uev_sched_q *sib = s->q[(q->index + i) % n];
+
+		if (atomic_load(&sib->idle) && atomic_exchange(&sib->idle, 0)) {
+			_uev_set_flags(sib->ctx, UEV_EG_BIT_SCHED);
+			break;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,262 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <uev/stats.h>
+
+#if CONFIG_UEV_STATS
+
+#include <errno.h>
+#include <string.h>
+
+#include <lwip/opt.h>
+#include <sys/socket.h>
+
+#define CROSSLOG_TAG "uev"
+#include <crosslog.h>
+
+/* Type order of the per-type watcher counts */
+static const uev_type_t types[] = {
+	UEV_IO_TYPE,
+	UEV_TIMER_TYPE,
+	UEV_TIMER_TS_TYPE,
+	UEV_EVENT_TYPE,
+	UEV_EMBED_TYPE,
+};
+
+#define NTYPES (sizeof(types) / sizeof(types[0]))
+
+#define WATCHER_SIZE 24
+
+static uint8_t *put16(uint8_t *p, uint16_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	return p + 2;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v)
+{
+	p = put16(p, v);
+	return put16(p, v >> 16);
+}
+
+static uint8_t *put64(uint8_t *p, uint64_t v)
+{
+	p = put32(p, v);
+	return put32(p, v >> 32);
+}
+
+static uint8_t *put_ctx(uev_stats_t *s, uint8_t *p)
+{
+	uev_ctx_t *ctx = s->w.ctx;
+	uint16_t count[NTYPES] = { 0 };
+	uint32_t rounds, round_last, round_max;
+	uev_t *w;
+	size_t i, l;
+
+	for (l = 0; l < UEV_LIST_MAX; l++) {
+		_UEV_FOREACH(w, ctx->watchers[l]) {
+			for (i = 0; i < NTYPES; i++) {
+				if (w->type == types[i])
+					count[i]++;
+			}
+		}
+	}
+
+	for (i = 0; i < NTYPES; i++)
+		p = put16(p, count[i]);
+
+	p = put32(p, ctx->stats.wakeups);
+	p = put32(p, ctx->stats.dispatches);
+	p = put64(p, ctx->stats.cb_time);
+	p = put32(p, ctx->stats.cb_max);
+	p = put32(p, ctx->stats.timers_fired);
+	p = put64(p, ctx->stats.timer_late);
+	p = put32(p, ctx->stats.timer_late_max);
+
+	_uev_iothread_stats(&rounds, &round_last, &round_max);
+	p = put32(p, rounds);
+	p = put32(p, round_last);
+	p = put32(p, round_max);
+
+	return p;
+}
+
+static uint8_t *put_watchers(uev_stats_t *s, uint8_t *p, uint16_t first)
+{
+	uev_ctx_t *ctx = s->w.ctx;
+	uint8_t *end = s->buf + sizeof(s->buf);
+	uint8_t *countp;
+	uint16_t total = 0;
+	uint8_t count = 0;
+	uev_t *w;
+	int l;
+
+	for (l = 0; l < UEV_LIST_MAX; l++) {
+		_UEV_FOREACH(w, ctx->watchers[l])
+			total++;
+	}
+
+	p = put16(p, total);
+	p = put16(p, first);
+	countp = p++;
+
+	for (l = 0; l < UEV_LIST_MAX; l++) {
+		_UEV_FOREACH(w, ctx->watchers[l]) {
+			if (first) {
+				first--;
+				continue;
+			}
+
+			if (end - p < WATCHER_SIZE || count == 0xff)
+				goto done;
+
+			*p++ = w->type;
+			*p++ = (w->active ? 1 : 0) | (_uev_watcher_held(w) ? 2 : 0);
+			p = put16(p, (uint16_t)w->fd);
+			p = put32(p, (uint32_t)(uintptr_t)w->cb);
+			p = put32(p, w->stats.dispatches);
+			p = put64(p, w->stats.cb_time);
+			p = put32(p, w->stats.cb_max);
+			count++;
+		}
+	}
+done:
+	*countp = count;
+
+	return p;
+}
+
+static void stats_cb(uev_t *w, void *arg, int events)
+{
+	uev_stats_t *s = (uev_stats_t *)arg;
+	struct sockaddr_storage sa;
+	socklen_t salen = sizeof(sa);
+	uint8_t req[4];
+	uint8_t *p;
+	ssize_t nbytes;
+
+	if (events & UEV_ERROR) {
+		CROSSLOGE("stats socket error");
+		return;
+	}
+
+	nbytes = recvfrom(w->fd, req, sizeof(req), MSG_DONTWAIT, (struct sockaddr *)&sa, &salen);
+	if (nbytes < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+			CROSSLOG_ERRNO("recvfrom");
+		return;
+	}
+
+	if (nbytes < 2 || req[0] != UEV_STATS_MAGIC)
+		return;
+
+	p = s->buf;
+	*p++ = UEV_STATS_MAGIC;
+	*p++ = 'S';
+	*p++ = UEV_STATS_VERSION;
+	*p++ = req[1];
+
+	switch (req[1]) {
+	case UEV_STATS_CMD_CTX:
+		p = put_ctx(s, p);
+		break;
+
+	case UEV_STATS_CMD_WATCHERS:
+		p = put_watchers(s, p, nbytes >= 4 ? req[2] | req[3] << 8 : 0);
+		break;
+
+	default:
+		return;
+	}
+
+	nbytes = sendto(w->fd, s->buf, p - s->buf, MSG_DONTWAIT, (struct sockaddr *)&sa, salen);
+	if (nbytes < 0)
+		CROSSLOG_ERRNO("sendto");
+}
+
+/**
+ * Serve statistics of a context
+ * @param ctx  A valid libuEv context, the one reported on
+ * @param s    Pointer to an uev_stats_t server
+ * @param fd   Bound UDP socket to serve requests on
+ *
+ * The server is an ordinary I/O watcher in @param ctx, so requests are
+ * answered from the event loop itself without a task of its own.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_stats_init(uev_ctx_t *ctx, uev_stats_t *s, int fd)
+{
+	if (!s) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return uev_io_init(ctx, &s->w, stats_cb, s, fd, UEV_READ);
+}
+
+/**
+ * Stop serving statistics
+ * @param s  Server to stop
+ *
+ * The socket is left open for the caller to close.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_stats_stop(uev_stats_t *s)
+{
+	if (!s) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return uev_io_stop(&s->w);
+}
+
+/**
+ * Reset the statistics of a context and its watchers
+ * @param ctx  A valid libuEv context
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_stats_reset(uev_ctx_t *ctx)
+{
+	uev_t *w;
+	int l;
+
+	if (!ctx) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+	for (l = 0; l < UEV_LIST_MAX; l++) {
+		_UEV_FOREACH(w, ctx->watchers[l])
+			memset(&w->stats, 0, sizeof(w->stats));
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_UEV_STATS */
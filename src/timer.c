@@ -170,6 +170,45 @@ int uev_timer_start(uev_t *w)
 	return uev_timer_set(w, w->u.t.timeout, w->u.t.period);
 }
 
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Arm all dormant timers at loop startup, as uev_timer_set() with their
+ * current timeout and period would, but from a single timestamp and
+ * without waking up the loop, which is the caller.  Thread-safe timers
+ * are locked one at a time, so the time spent with interrupts off does
+ * not grow with the number of timers.  Returns the earliest deadline.
+ *
+ * Unlike the original uev_run(), which re-armed every timer, a timer
+ * already armed keeps its deadline, so that uev_run() after
+ * uev_run_for() does not push back the timers armed by the latter.
+ */
+uint64_t _uev_timer_start_all(uev_ctx_t *ctx)
+{
+	uint64_t now = _uev_timer_now() / 1000;
+	uint64_t next_deadline = 0xffffffffffffffff;
+	uev_t *w;
+
+	_UEV_FOREACH(w, ctx->watchers[UEV_LIST_TIMER]) {
+		if (w->type == UEV_TIMER_TS_TYPE)
+			_uev_critical_enter();
+
+		if (!w->u.t.deadline) {
+			if (w->u.t.timeout)
+				w->u.t.deadline = now + w->u.t.timeout;
+			w->active = 1;
+		}
+
+		if (w->u.t.deadline && w->u.t.deadline < next_deadline)
+			next_deadline = w->u.t.deadline;
+
+		if (w->type == UEV_TIMER_TS_TYPE)
+			_uev_critical_exit();
+	}
+
+	return next_deadline;
+}
+
 /* Private to libuEv, do not use directly! */
 int _uev_timer_stop(uev_t *w)
 {
@@ -192,12 +231,19 @@ int uev_timer_stop(uev_t *w)
 {
 	int rc;
 
+	if (!w || !w->ctx) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	_uev_watcher_forget(w);
+
 	rc = _uev_timer_stop(w);
 	if (rc)
 		return rc;
 
 	/* Remove from internal list */
-	_UEV_REMOVE(w, w->ctx->watchers);
+	_UEV_REMOVE(w, _UEV_LIST(w));
 
 	return 0;
 }
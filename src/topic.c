@@ -0,0 +1,344 @@
+/* libuEv - Micro event loop library
+ *
+ * Copyright (c) 2026  The libuEv contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <uev/topic.h>
+#include "mpq.h"
+
+static inline uev_topic_msg_t *topic_slot(uev_topic_t *t, size_t i)
+{
+	return (uev_topic_msg_t *)(t->buf + i * UEV_TOPIC_SLOTSZ(t->size));
+}
+
+/* Claim a free slot for the publisher, free slots have no references */
+static uev_topic_msg_t *topic_claim(uev_topic_t *t)
+{
+	size_t start = atomic_fetch_add(&t->hint, 1);
+	size_t i;
+
+	for (i = 0; i < t->nslots; i++) {
+		uev_topic_msg_t *m = topic_slot(t, (start + i) % t->nslots);
+		int refs = 0;
+
+		if (atomic_compare_exchange_strong(&m->refs, &refs, 1))
+			return m;
+	}
+
+	return NULL;
+}
+
+static void topic_cb(uev_t *w, void *arg, int events)
+{
+	uev_topic_sub_t *s = (uev_topic_sub_t *)arg;
+	uev_topic_msg_t *msgs[UEV_TOPIC_BATCH];
+	uintptr_t m;
+	size_t i, n = 0;
+
+	if (events & UEV_ERROR)
+		return;
+
+	while (n < UEV_TOPIC_BATCH && _uev_mpq_pop(s->q, &m))
+		msgs[n++] = (uev_topic_msg_t *)m;
+
+	if (!n)
+		return;
+
+	/* More than a batch queued, come back after the others had a go */
+	if (n == UEV_TOPIC_BATCH)
+		uev_event_post(w);
+
+	s->cb(s, s->arg, msgs, n);
+
+	for (i = 0; i < n; i++)
+		uev_topic_release(msgs[i]);
+}
+
+/**
+ * Create a topic
+ * @param t       Pointer to an uev_topic_t topic
+ * @param buf     Slot storage of UEV_TOPIC_BUFSZ(@param nslots, @param size) bytes
+ * @param nslots  Number of messages in flight at most
+ * @param size    Max. message size in bytes
+ *
+ * A topic is not tied to any context, publishers and subscribers may
+ * run in any task.  Since @param buf is provided by the caller, no
+ * memory is allocated for the topic itself.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_topic_init(uev_topic_t *t, void *buf, size_t nslots, size_t size)
+{
+	size_t i;
+
+	if (!t || !buf || !nslots || !size) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	t->buf    = (unsigned char *)buf;
+	t->nslots = nslots;
+	t->size   = size;
+	atomic_init(&t->hint, 0);
+	atomic_init(&t->dropped, 0);
+
+	for (i = 0; i < UEV_TOPIC_MAX_SUBS; i++) {
+		atomic_init(&t->subs[i], 0);
+		atomic_init(&t->epoch[i], 0);
+		atomic_init(&t->busy[i][0], 0);
+		atomic_init(&t->busy[i][1], 0);
+	}
+
+	for (i = 0; i < nslots; i++) {
+		atomic_init(&topic_slot(t, i)->refs, 0);
+		topic_slot(t, i)->len = 0;
+	}
+
+	return 0;
+}
+
+/**
+ * Publish a message
+ * @param t     Topic to publish to
+ * @param data  Message to copy into the topic
+ * @param len   Length of @param data, at most the message size of @param t
+ *
+ * Copies @param data once and queues a reference to every subscriber.
+ * Safe to call from any task or ISR.  Subscribers with a full queue
+ * miss the message and count it in their dropped counter.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error,
+ * %ENOBUFS if all slots are still referenced.
+ */
+int uev_topic_publish(uev_topic_t *t, const void *data, size_t len)
+{
+	uev_topic_msg_t *m;
+	size_t i;
+
+	if (!t || (!data && len)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (len > t->size) {
+		errno = EMSGSIZE;
+		return -1;
+	}
+
+	m = topic_claim(t);
+	if (!m) {
+		atomic_fetch_add(&t->dropped, 1);
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	memcpy(uev_topic_data(m), data, len);
+	m->len = len;
+
+	for (i = 0; i < UEV_TOPIC_MAX_SUBS; i++) {
+		uev_topic_sub_t *s;
+		uintptr_t ref = (uintptr_t)m;
+		unsigned int epoch, e;
+
+		if (!atomic_load(&t->subs[i]))
+			continue;
+
+		/*
+		 * Pairs with the wait in uev_topic_unsubscribe().  Only
+		 * count us in an epoch still current after the count, else
+		 * an unsubscribe may have flipped past it unseen.
+		 */
+		for (;;) {
+			epoch = atomic_load(&t->epoch[i]);
+			e = epoch & 1;
+			atomic_fetch_add(&t->busy[i][e], 1);
+			if (atomic_load(&t->epoch[i]) == epoch)
+				break;
+			atomic_fetch_sub(&t->busy[i][e], 1);
+		}
+
+		s = (uev_topic_sub_t *)atomic_load(&t->subs[i]);
+		if (s) {
+			atomic_fetch_add(&m->refs, 1);
+			if (_uev_mpq_push(s->q, &ref)) {
+				atomic_fetch_sub(&m->refs, 1);
+				atomic_fetch_add(&s->dropped, 1);
+			} else {
+				uev_event_post(&s->w);
+			}
+		}
+
+		atomic_fetch_sub(&t->busy[i][e], 1);
+	}
+
+	/* Drop the publisher's reference */
+	uev_topic_release(m);
+
+	return 0;
+}
+
+/**
+ * Subscribe to a topic
+ * @param ctx    A valid libuEv context to run @param cb in
+ * @param t      Topic to subscribe to
+ * @param s      Pointer to an uev_topic_sub_t subscription
+ * @param cb     Callback with a batch of messages
+ * @param arg    Optional callback argument
+ * @param depth  Max. number of messages queued, a power of two
+ *
+ * The queue is allocated from @param ctx.  The messages passed to
+ * @param cb are released when it returns, unless retained with
+ * uev_topic_retain().
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_topic_subscribe(uev_ctx_t *ctx, uev_topic_t *t, uev_topic_sub_t *s,
+			uev_topic_cb_t *cb, void *arg, size_t depth)
+{
+	size_t i;
+
+	if (!ctx || !t || !s || !cb) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	s->topic = t;
+	s->cb    = cb;
+	s->arg   = arg;
+	atomic_init(&s->dropped, 0);
+
+	s->q = _uev_mpq_new(ctx, depth, sizeof(uintptr_t));
+	if (!s->q)
+		return -1;
+
+	if (uev_event_init(ctx, &s->w, topic_cb, s))
+		goto fail;
+
+	for (i = 0; i < UEV_TOPIC_MAX_SUBS; i++) {
+		uintptr_t none = 0;
+
+		if (atomic_compare_exchange_strong(&t->subs[i], &none, (uintptr_t)s))
+			return 0;
+	}
+
+	uev_event_stop(&s->w);
+	errno = ENOSPC;
+fail:
+	_uev_mpq_free(ctx, s->q);
+	s->q = NULL;
+	return -1;
+}
+
+/**
+ * Cancel a subscription
+ * @param s  Subscription to cancel
+ *
+ * Messages still queued are released without calling the callback.
+ * Must not be called from an ISR.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_topic_unsubscribe(uev_topic_sub_t *s)
+{
+	uev_topic_t *t;
+	uintptr_t m;
+	size_t i;
+
+	if (!s || !s->topic || !s->q) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	t = s->topic;
+	for (i = 0; i < UEV_TOPIC_MAX_SUBS; i++) {
+		uintptr_t self = (uintptr_t)s;
+
+		if (atomic_compare_exchange_strong(&t->subs[i], &self, 0))
+			break;
+	}
+
+	/*
+	 * Publishers which found us may still be pushing to our queue.
+	 * Later ones count in the new epoch and no longer see us, so
+	 * this only waits for those already under way.
+	 */
+	if (i < UEV_TOPIC_MAX_SUBS) {
+		unsigned int e = atomic_fetch_add(&t->epoch[i], 1) & 1;
+
+		while (atomic_load(&t->busy[i][e]))
+			vTaskDelay(1);
+	}
+
+	uev_event_stop(&s->w);
+
+	while (_uev_mpq_pop(s->q, &m))
+		uev_topic_release((uev_topic_msg_t *)m);
+
+	_uev_mpq_free(s->w.ctx, s->q);
+	s->q = NULL;
+	s->topic = NULL;
+
+	return 0;
+}
+
+/**
+ * Keep a message after the callback returns
+ * @param m  Message passed to a subscriber callback
+ *
+ * Each call must be paired with a call to uev_topic_release().
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_topic_retain(uev_topic_msg_t *m)
+{
+	if (!m) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	atomic_fetch_add(&m->refs, 1);
+
+	return 0;
+}
+
+/**
+ * Release a message
+ * @param m  Message retained with uev_topic_retain()
+ *
+ * The slot is reused once the last reference is released.  Safe to
+ * call from any task or ISR.
+ *
+ * @return POSIX OK(0) or non-zero with @param errno set on error.
+ */
+int uev_topic_release(uev_topic_msg_t *m)
+{
+	if (!m) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	atomic_fetch_sub(&m->refs, 1);
+
+	return 0;
+}
@@ -55,7 +55,19 @@ void _uev_critical_exit(void) {
 }
 
 void _uev_set_flags(uev_ctx_t *ctx, const EventBits_t bits) {
-	if (xPortInIsrContext()) {
+	int isr = xPortInIsrContext();
+
+	/* From a callback, the loop picks these up before it blocks */
+	if (!isr && ctx->owner == xTaskGetCurrentTaskHandle()) {
+		ctx->pending |= bits;
+		goto parent;
+	}
+
+	/* The loop has yet to take these, no need to wake it up again */
+	if ((atomic_fetch_or(&ctx->wake_pending, bits) & bits) == bits)
+		return;
+
+	if (isr) {
 		BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 		xEventGroupSetBitsFromISR(ctx->egh, bits, &xHigherPriorityTaskWoken);
 
@@ -66,6 +78,11 @@ void _uev_set_flags(uev_ctx_t *ctx, const EventBits_t bits) {
 	else {
 		xEventGroupSetBits(ctx->egh, bits);
 	}
+
+parent:
+	/* Wake up the parent, it runs this context for us */
+	if (ctx->embed)
+		_uev_set_flags(ctx->embed->ctx, UEV_EG_BIT_EMBED);
 }
 
 /* Private to libuEv, do not use directly! */
@@ -76,6 +93,18 @@ int _uev_watcher_init(uev_ctx_t *ctx, uev_t *w, uev_type_t type, uev_cb_t *cb, v
 		return -1;
 	}
 
+	/*
+	 * A member initialized again leaves its group.  A watcher never
+	 * initialized may hold anything, so the group link is only trusted
+	 * if uev_group_add() set it for this very watcher.  Done first,
+	 * leaving depends on the old type.
+	 */
+	if (w->group && w->gself == w)
+		uev_group_del(w);
+	w->group = NULL;
+	w->gself = NULL;
+	list_clear_node(&w->gnode);
+
 	w->ctx    = ctx;
 	w->type   = type;
 	w->active = 0;
@@ -84,10 +113,14 @@ int _uev_watcher_init(uev_ctx_t *ctx, uev_t *w, uev_type_t type, uev_cb_t *cb, v
 	w->arg    = arg;
 	w->events = events;
 
+	atomic_init(&w->iot.mask, 0);
 	atomic_init(&w->iot.events, 0);
+#if CONFIG_UEV_STATS
+	memset(&w->stats, 0, sizeof(w->stats));
+#endif
 
 	if (w->type == UEV_TIMER_TS_TYPE) {
-		_UEV_INSERT(w, w->ctx->watchers);
+		_UEV_INSERT(w, _UEV_LIST(w));
 		ctx->watchers_changed = 1;
 	}
 
@@ -118,39 +151,78 @@ int _uev_watcher_start(uev_t *w)
 
 	if (w->type != UEV_TIMER_TS_TYPE) {
 		/* Add to internal list for bookkeeping */
-		_UEV_INSERT(w, w->ctx->watchers);
+		_UEV_INSERT(w, _UEV_LIST(w));
 		w->ctx->watchers_changed = 1;
 	}
 
 	return 0;
 }
 
-/* Private to libuEv, do not use directly! */
-int _uev_watcher_stop(uev_t *w)
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Stop a watcher without waking up the iothread, the caller does that
+ * once after unlinking any number of I/O watchers.
+ */
+int _uev_watcher_unlink(uev_t *w)
 {
 	if (!w) {
 		errno = EINVAL;
 		return -1;
 	}
 
+	_uev_watcher_forget(w);
+
 	if (!_uev_watcher_active(w))
 		return 0;
 
 	w->active = 0;
 
 	if (w->type == UEV_IO_TYPE) {
-		_uev_iothread_watcher_remove(w);
+		_uev_iothread_watcher_unlink(w);
 	}
 
 	if (w->type != UEV_TIMER_TS_TYPE) {
 		/* Remove from internal list */
-		_UEV_REMOVE(w, w->ctx->watchers);
+		_UEV_REMOVE(w, _UEV_LIST(w));
 		w->ctx->watchers_changed = 1;
 	}
 
 	return 0;
 }
 
+/* Private to libuEv, do not use directly! */
+int _uev_watcher_stop(uev_t *w)
+{
+	int wake = _uev_watcher_active(w) && w->type == UEV_IO_TYPE;
+
+	if (_uev_watcher_unlink(w))
+		return -1;
+
+	if (wake)
+		_uev_iothread_interrupt();
+
+	return 0;
+}
+
+/*
+ * Private to libuEv, do not use directly!
+ *
+ * Called when a watcher is stopped, its memory may be gone by the time
+ * its callback returns so it must not be touched after that.
+ */
+void _uev_watcher_forget(uev_t *w)
+{
+	if (w->ctx && w->ctx->current == w)
+		w->ctx->current = NULL;
+}
+
+/* Private to libuEv, do not use directly! */
+int _uev_watcher_held(uev_t *w)
+{
+	return w->group && atomic_load(&w->group->suspended);
+}
+
 /* Private to libuEv, do not use directly! */
 int _uev_watcher_active(uev_t *w)
 {
@@ -168,22 +240,31 @@ int _uev_watcher_active(uev_t *w)
  */
 int uev_init(uev_ctx_t *ctx)
 {
+	int i;
+
 	if (!ctx) {
 		errno = EINVAL;
 		return -1;
 	}
 
 	memset(ctx, 0, sizeof(*ctx));
+	atomic_init(&ctx->mem.used, 0);
+	atomic_init(&ctx->mem.peak, 0);
 
 #if configSUPPORT_STATIC_ALLOCATION
 	ctx->egh = xEventGroupCreateStatic(&ctx->egb);
 #else
+	_uev_mem_charge(ctx, sizeof(StaticEventGroup_t));
 	ctx->egh = xEventGroupCreate();
 #endif
 	configASSERT(ctx->egh);
 
 	atomic_init(&ctx->running, 0);
+	atomic_init(&ctx->wake_pending, 0);
 	ctx->watchers_changed = 0;
+	for (i = 0; i < UEV_LIST_MAX; i++)
+		ctx->list_deadline[i] = 0xffffffffffffffff;
+	ctx->next_deadline = 0xffffffffffffffff;
 
 	return 0;
 }
@@ -197,38 +278,295 @@ int uev_init(uev_ctx_t *ctx)
 int uev_exit(uev_ctx_t *ctx)
 {
 	uev_t *w;
+	int i;
 
 	if (!ctx) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	_UEV_FOREACH(w, ctx->watchers) {
-		/* Remove from internal list */
-		_UEV_REMOVE(w, ctx->watchers);
+	for (i = 0; i < UEV_LIST_MAX; i++) {
+		_UEV_FOREACH(w, ctx->watchers[i]) {
+			/* Remove from internal list */
+			_UEV_REMOVE(w, ctx->watchers[i]);
 
-		if (!_uev_watcher_active(w))
-			continue;
+			if (!_uev_watcher_active(w))
+				continue;
 
-		switch (w->type) {
-		case UEV_IO_TYPE:
-			uev_io_stop(w);
-			break;
+			switch (w->type) {
+			case UEV_IO_TYPE:
+				uev_io_stop(w);
+				break;
 
-		case UEV_TIMER_TYPE:
-		case UEV_TIMER_TS_TYPE:
-			uev_timer_stop(w);
-			break;
+			case UEV_TIMER_TYPE:
+			case UEV_TIMER_TS_TYPE:
+				uev_timer_stop(w);
+				break;
 
-		case UEV_EVENT_TYPE:
-			uev_event_stop(w);
-			break;
+			case UEV_EVENT_TYPE:
+				uev_event_stop(w);
+				break;
+
+			case UEV_EMBED_TYPE:
+				uev_embed_stop(w);
+				break;
+			}
 		}
+
+		ctx->watchers[i] = NULL;
 	}
 
-	ctx->watchers = NULL;
 	atomic_store(&ctx->running, 0);
 	vEventGroupDelete(ctx->egh);
+#if !configSUPPORT_STATIC_ALLOCATION
+	_uev_mem_uncharge(ctx, sizeof(StaticEventGroup_t));
+#endif
+
+	return 0;
+}
+
+/*
+ * Check a watcher and run its callback if it is ready.  Also lowers
+ * @next_deadline to the deadline of a timer watcher.
+ *
+ * Returns 1 if the callback was called, otherwise 0.
+ */
+static int uev_dispatch(uev_t *w, EventBits_t bits, uint64_t *next_deadline)
+{
+	bool runcb = false;
+	int events = 0;
+
+	if (!w->active || _uev_watcher_held(w))
+		return 0;
+
+	switch (w->type) {
+	case UEV_EVENT_TYPE:
+		if (!(bits & UEV_EG_BIT_EVENT))
+			break;
+
+		if (atomic_exchange(&w->u.e.posted, false)) {
+			runcb = true;
+			events = UEV_READ;
+		}
+		break;
+
+	case UEV_TIMER_TS_TYPE:
+	case UEV_TIMER_TYPE: {
+		uint64_t now = _uev_timer_now() / 1000;
+
+		if (w->type == UEV_TIMER_TS_TYPE) {
+			_uev_critical_enter();
+		}
+
+		if (now > 0 && w->u.t.deadline && now > w->u.t.deadline) {
+			runcb = true;
+			events = UEV_READ;
+
+#if CONFIG_UEV_STATS
+			uint32_t late = now - w->u.t.deadline;
+
+			w->ctx->stats.timers_fired++;
+			w->ctx->stats.timer_late += late;
+			if (late > w->ctx->stats.timer_late_max)
+				w->ctx->stats.timer_late_max = late;
+#endif
+
+			if (!w->u.t.period)
+				w->u.t.timeout = 0;
+
+			if (!w->u.t.timeout)
+				_uev_timer_stop(w);
+			else {
+				w->u.t.deadline = now + w->u.t.period;
+			}
+		}
+
+		if (w->u.t.deadline && w->u.t.deadline < *next_deadline)
+			*next_deadline = w->u.t.deadline;
+
+		if (w->type == UEV_TIMER_TS_TYPE) {
+			_uev_critical_exit();
+		}
+		break;
+	}
+
+	case UEV_IO_TYPE: {
+		if (!(bits & UEV_EG_BIT_IO))
+			break;
+
+		unsigned int ioevents = atomic_load(&w->iot.events);
+		if (ioevents) {
+			events |= ioevents;
+			runcb = true;
+		}
+		break;
+	}
+
+	case UEV_EMBED_TYPE: {
+		uev_ctx_t *child = w->u.c.ctx;
+
+		if (_uev_embed_pending(child)) {
+			runcb = true;
+			events = UEV_READ;
+
+			/* Without a callback the child is run right here */
+			if (!w->cb)
+				uev_embed_sweep(w);
+		}
+
+		if (child->next_deadline < *next_deadline)
+			*next_deadline = child->next_deadline;
+
+		if (!w->cb)
+			return runcb;
+		break;
+	}
+
+	default:
+		return 0;
+	}
+
+	if (runcb && w->cb) {
+		uev_ctx_t *ctx = w->ctx;
+		uev_type_t type = w->type;
+#if CONFIG_UEV_STATS
+		uint64_t start = _uev_timer_now();
+		uint32_t elapsed;
+#endif
+
+		/*
+		 * Consume I/O events before the callback, which
+		 * may stop the watcher and release its memory.
+		 */
+		if (type == UEV_IO_TYPE)
+			atomic_fetch_and(&w->iot.events, ~((unsigned int)events));
+
+		ctx->current = w;
+#if CONFIG_UEV_PROFILER
+		atomic_store(&ctx->prof_cb, (uintptr_t)w->cb);
+#endif
+		w->cb(w, w->arg, events & UEV_EVENT_MASK);
+#if CONFIG_UEV_PROFILER
+		atomic_store(&ctx->prof_cb, 0);
+#endif
+
+#if CONFIG_UEV_STATS
+		elapsed = _uev_timer_now() - start;
+		ctx->stats.dispatches++;
+		ctx->stats.cb_time += elapsed;
+		if (elapsed > ctx->stats.cb_max)
+			ctx->stats.cb_max = elapsed;
+
+		/* Still registered, so still safe to touch */
+		if (ctx->current == w) {
+			w->stats.dispatches++;
+			w->stats.cb_time += elapsed;
+			if (elapsed > w->stats.cb_max)
+				w->stats.cb_max = elapsed;
+		}
+#endif
+		ctx->current = NULL;
+
+		if (type == UEV_IO_TYPE)
+			_uev_iothread_interrupt();
+
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Same checks as uev_dispatch(), without any side effects */
+static int uev_ready(uev_t *w, EventBits_t bits, uint64_t now)
+{
+	if (!w->active || _uev_watcher_held(w))
+		return 0;
+
+	if (!w->cb && w->type != UEV_EMBED_TYPE)
+		return 0;
+
+	switch (w->type) {
+	case UEV_EVENT_TYPE:
+		return (bits & UEV_EG_BIT_EVENT) && atomic_load(&w->u.e.posted);
+
+	case UEV_TIMER_TS_TYPE:
+	case UEV_TIMER_TYPE:
+		return now > 0 && w->u.t.deadline && now > w->u.t.deadline;
+
+	case UEV_IO_TYPE:
+		return (bits & UEV_EG_BIT_IO) && atomic_load(&w->iot.events);
+
+	case UEV_EMBED_TYPE:
+		return _uev_embed_pending(w->u.c.ctx);
+
+	default:
+		return 0;
+	}
+}
+
+/* Start all dormant timers, returns the earliest deadline */
+static uint64_t uev_start_timers(uev_ctx_t *ctx, uint64_t next_deadline)
+{
+	uint64_t deadline = _uev_timer_start_all(ctx);
+
+	ctx->list_deadline[UEV_LIST_TIMER] = deadline;
+
+	return deadline < next_deadline ? deadline : next_deadline;
+}
+
+/*
+ * Dispatch all watchers of the lists selected by @bits, and of lists
+ * whose earliest deadline has passed.  The other lists are not walked
+ * at all.  Stops after @max_callbacks callbacks or when @budget_us has
+ * passed since @start, zero for no limit.
+ *
+ * Returns 1 if stopped by a limit, otherwise 0.
+ */
+static int uev_sweep(uev_ctx_t *ctx, EventBits_t bits, uint64_t start,
+		     unsigned int budget_us, unsigned int max_callbacks)
+{
+	uint64_t now = _uev_timer_now() / 1000;
+	uint64_t deadline;
+	unsigned int ncb = 0;
+	unsigned int lists = 0;
+	uev_t *w;
+	int i;
+
+	for (i = 0; i < UEV_LIST_MAX; i++) {
+		if ((bits & _uev_list_bit(i)) || now > ctx->list_deadline[i])
+			lists |= 1 << i;
+	}
+
+again:
+	ctx->watchers_changed = 0;
+	for (i = 0; i < UEV_LIST_MAX; i++) {
+		if (!(lists & (1 << i)))
+			continue;
+
+		deadline = 0xffffffffffffffff;
+		_UEV_FOREACH(w, ctx->watchers[i]) {
+			if (!uev_dispatch(w, bits, &deadline))
+				continue;
+
+			ncb++;
+			if (max_callbacks && ncb >= max_callbacks)
+				return 1;
+
+			if (budget_us && _uev_timer_now() - start >= budget_us)
+				return 1;
+
+			if (ctx->watchers_changed)
+				goto again;
+		}
+		ctx->list_deadline[i] = deadline;
+	}
+
+	deadline = 0xffffffffffffffff;
+	for (i = 0; i < UEV_LIST_MAX; i++) {
+		if (ctx->list_deadline[i] < deadline)
+			deadline = ctx->list_deadline[i];
+	}
+	ctx->next_deadline = deadline;
 
 	return 0;
 }
@@ -249,7 +587,6 @@ int uev_exit(uev_ctx_t *ctx)
  */
 int uev_run(uev_ctx_t *ctx, int flags)
 {
-	uev_t *w;
 	uint64_t next_deadline = 0xffffffffffffffff;
 
 	if (!ctx || !ctx->egh) {
@@ -261,17 +598,11 @@ int uev_run(uev_ctx_t *ctx, int flags)
 		next_deadline = 0;
 
 	/* Start the event loop */
+	ctx->owner = xTaskGetCurrentTaskHandle();
 	atomic_store(&ctx->running, 1);
 
 	/* Start all dormant timers */
-	_UEV_FOREACH(w, ctx->watchers) {
-		if (w->type == UEV_TIMER_TYPE || w->type == UEV_TIMER_TS_TYPE) {
-			uev_timer_set(w, w->u.t.timeout, w->u.t.period);
-
-			if (w->u.t.deadline < next_deadline)
-				next_deadline = w->u.t.deadline;
-		}
-	}
+	next_deadline = uev_start_timers(ctx, next_deadline);
 
 	while (atomic_load(&ctx->running)) {
 		uint64_t now = _uev_timer_now() / 1000;
@@ -284,91 +615,105 @@ int uev_run(uev_ctx_t *ctx, int flags)
 		else
 			tickstowait = next_deadline ? ((next_deadline - now) / portTICK_PERIOD_MS) : 0;
 
-		EventBits_t bits = xEventGroupWaitBits(ctx->egh, UEV_EG_MASK, pdTRUE, pdFALSE, tickstowait);
-again:
-		next_deadline = 0xffffffffffffffff;
-		ctx->watchers_changed = 0;
-		_UEV_FOREACH(w, ctx->watchers) {
-			bool runcb = false;
-			int events = 0;
-
-			if (!w->active)
-				continue;
-
-			switch (w->type) {
-			case UEV_EVENT_TYPE:
-				if (!(bits & UEV_EG_BIT_EVENT))
-					break;
-
-				if (atomic_exchange(&w->u.e.posted, false)) {
-					runcb = true;
-					events = UEV_READ;
-				}
-				break;
-
-			case UEV_TIMER_TS_TYPE:
-			case UEV_TIMER_TYPE: {
-				uint64_t now = _uev_timer_now() / 1000;
-
-				if (w->type == UEV_TIMER_TS_TYPE) {
-					_uev_critical_enter();
-				}
+		/* Posted from our own task, or left over by uev_run_for() */
+		if (ctx->pending)
+			tickstowait = 0;
 
-				if (now > 0 && w->u.t.deadline && now > w->u.t.deadline) {
-					runcb = true;
-					events = UEV_READ;
+		/* Run a deferred task, ours or a sibling's, instead of blocking */
+		if (tickstowait && ctx->sched && _uev_sched_run(ctx))
+			tickstowait = 0;
 
-					if (!w->u.t.period)
-						w->u.t.timeout = 0;
+		/* Write out log records when there is nothing else to do */
+		if (tickstowait && ctx->log && _uev_log_drain(ctx))
+			tickstowait = 0;
 
-					if (!w->u.t.timeout)
-						_uev_timer_stop(w);
-					else {
-						w->u.t.deadline = now + w->u.t.period;
-					}
-				}
+		/* Only pick up what other tasks posted if we have work already */
+		EventBits_t bits;
+		if (tickstowait)
+			bits = xEventGroupWaitBits(ctx->egh, UEV_EG_MASK, pdTRUE, pdFALSE, tickstowait);
+		else
+			bits = xEventGroupClearBits(ctx->egh, UEV_EG_MASK);
+		bits &= UEV_EG_MASK;
+		bits |= atomic_exchange(&ctx->wake_pending, 0);
+		if (ctx->sched)
+			_uev_sched_awake(ctx);
+#if CONFIG_UEV_STATS
+		ctx->stats.wakeups++;
+#endif
+		bits |= ctx->pending;
+		ctx->pending = 0;
 
-				if (w->u.t.deadline && w->u.t.deadline < next_deadline)
-					next_deadline = w->u.t.deadline;
+		uev_sweep(ctx, bits, 0, 0, 0);
+		next_deadline = ctx->next_deadline;
 
-				if (w->type == UEV_TIMER_TS_TYPE) {
-					_uev_critical_exit();
-				}
-				break;
-			}
+		/* A bounded slice of our own tasks, even when never idle */
+		if (ctx->sched && atomic_load(&ctx->running))
+			_uev_sched_slice(ctx);
 
-			case UEV_IO_TYPE: {
-				if (!(bits & UEV_EG_BIT_IO))
-					break;
+		if (flags & UEV_ONCE)
+			break;
+	}
 
-				unsigned int ioevents = atomic_load(&w->iot.events);
-				if (ioevents) {
-					events |= ioevents;
-					runcb = true;
-				}
-				break;
-			}
+	return 0;
+}
 
-			default:
-				continue;
-			}
+/**
+ * Run the event loop for a bounded amount of work
+ * @param ctx            A valid libuEv context
+ * @param budget_us      Time budget in microseconds, or zero for no limit
+ * @param max_callbacks  Max. number of callbacks to run, or zero for no limit
+ *
+ * Serves whatever is ready without blocking, like uev_run() with
+ * %UEV_ONCE and %UEV_NONBLOCK, but returns as soon as either limit is
+ * reached.  The budget is checked after each callback, so a single
+ * slow callback can overrun it.  Ready work which was not served is
+ * kept for the next call to uev_run_for() or uev_run().
+ *
+ * @return The number of watchers still ready, zero when all work has
+ * been served, or -1 with @param errno set on error.
+ */
+int uev_run_for(uev_ctx_t *ctx, unsigned int budget_us, unsigned int max_callbacks)
+{
+	uint64_t start, now;
+	EventBits_t bits;
+	uev_t *w;
+	int ready, i;
 
-			if (runcb && w->cb) {
-				w->cb(w, w->arg, events & UEV_EVENT_MASK);
+	if (!ctx || !ctx->egh) {
+		errno = EINVAL;
+		return -1;
+	}
 
-				if (w->type == UEV_IO_TYPE) {
-					atomic_fetch_and(&w->iot.events, ~((unsigned int)events));
-					_uev_iothread_interrupt();
-				}
+	ctx->owner = xTaskGetCurrentTaskHandle();
+	if (!atomic_load(&ctx->running)) {
+		atomic_store(&ctx->running, 1);
+		uev_start_timers(ctx, 0);
+	}
 
-				if (ctx->watchers_changed)
-					goto again;
-			}
-		}
+	start = _uev_timer_now();
+	bits = xEventGroupClearBits(ctx->egh, UEV_EG_MASK) & UEV_EG_MASK;
+	bits |= atomic_exchange(&ctx->wake_pending, 0);
+#if CONFIG_UEV_STATS
+	ctx->stats.wakeups++;
+#endif
+	bits |= ctx->pending;
+	ctx->pending = 0;
+
+	/*
+	 * Keep what a limit left unserved, on top of what the callbacks
+	 * posted to their own context meanwhile, see _uev_set_flags().
+	 */
+	if (uev_sweep(ctx, bits, start, budget_us, max_callbacks))
+		ctx->pending |= bits;
+	if (!ctx->pending)
+		return 0;
 
-		if (flags & UEV_ONCE)
-			break;
+	ready = 0;
+	now = _uev_timer_now() / 1000;
+	for (i = 0; i < UEV_LIST_MAX; i++) {
+		_UEV_FOREACH(w, ctx->watchers[i])
+			ready += uev_ready(w, ctx->pending, now);
 	}
 
-	return 0;
+	return ready;
 }
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Query and decode libuEv statistics served by uev_stats_init()."""
+
+import argparse
+import socket
+import struct
+import sys
+
+MAGIC = ord('U')
+VERSION = 1
+CMD_CTX = 1
+CMD_WATCHERS = 2
+
+TYPES = {1: 'io', 2: 'timer', 3: 'timer-ts', 4: 'event', 5: 'embed'}
+
+CTX_FMT = '<5H II Q I I Q I III'
+CTX_FIELDS = (
+    'wakeups', 'dispatches', 'cb_time_us', 'cb_max_us',
+    'timers_fired', 'timer_late_ms', 'timer_late_max_ms',
+    'iothread_rounds', 'iothread_round_last_us', 'iothread_round_max_us',
+)
+WATCHER_FMT = '<BBhIIQI'
+
+
+def request(sock, addr, cmd, first=0):
+    sock.sendto(struct.pack('<BBH', MAGIC, cmd, first), addr)
+    data, _ = sock.recvfrom(65535)
+    magic, s, version, rcmd = struct.unpack_from('<BBBB', data)
+    if magic != MAGIC or s != ord('S') or rcmd != cmd:
+        raise ValueError('bad reply')
+    if version != VERSION:
+        raise ValueError('unsupported version %d' % version)
+    return data[4:]
+
+
+def decode_ctx(payload):
+    values = struct.unpack_from(CTX_FMT, payload)
+    stats = {'watchers': dict(zip(TYPES.values(), values[:5]))}
+    stats.update(zip(CTX_FIELDS, values[5:]))
+    return stats
+
+
+def decode_watchers(payload):
+    total, first, count = struct.unpack_from('<HHB', payload)
+    off = struct.calcsize('<HHB')
+    watchers = []
+    for _ in range(count):
+        wtype, flags, fd, cb, dispatches, cb_time, cb_max = \
+            struct.unpack_from(WATCHER_FMT, payload, off)
+        off += struct.calcsize(WATCHER_FMT)
+        watchers.append({
+            'type': TYPES.get(wtype, str(wtype)),
+            'active': bool(flags & 1),
+            'suspended': bool(flags & 2),
+            'fd': fd,
+            'cb': cb,
+            'dispatches': dispatches,
+            'cb_time_us': cb_time,
+            'cb_max_us': cb_max,
+        })
+    return total, first, watchers
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('host')
+    parser.add_argument('port', type=int)
+    parser.add_argument('--timeout', type=float, default=2.0)
+    args = parser.parse_args()
+
+    addr = (args.host, args.port)
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(args.timeout)
+
+    stats = decode_ctx(request(sock, addr, CMD_CTX))
+    print('watchers: ' + ' '.join('%s=%d' % kv for kv in stats.pop('watchers').items()))
+    for key, value in stats.items():
+        print('%s: %d' % (key, value))
+
+    print('\n%-8s %-6s %5s %-10s %10s %12s %9s' %
+          ('type', 'state', 'fd', 'cb', 'dispatches', 'cb_time_us', 'cb_max_us'))
+    first = 0
+    while True:
+        total, _, watchers = decode_watchers(request(sock, addr, CMD_WATCHERS, first))
+        for w in watchers:
+            state = 'susp' if w['suspended'] else 'active' if w['active'] else 'idle'
+            print('%-8s %-6s %5d 0x%08x %10d %12d %9d' %
+                  (w['type'], state, w['fd'], w['cb'], w['dispatches'],
+                   w['cb_time_us'], w['cb_max_us']))
+        first += len(watchers)
+        if not watchers or first >= total:
+            break
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())